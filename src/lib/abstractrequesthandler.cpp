@@ -62,6 +62,11 @@ AbstractRequestHandler::AbstractRequestHandler()
 {
 }
 
+AbstractRequestHandler::AbstractRequestHandler(AbstractRequestHandlerPrivate *d)
+    : d_ptr(d)
+{
+}
+
 /*!
  * \brief Destructor for RequestHandler.
  */
@@ -90,63 +95,135 @@ QString AbstractRequestHandler::handlerName() const
 /*!
  * \brief Sends a HEAD request.
  */
-Response *AbstractRequestHandler::head(const Request &request)
+Response *AbstractRequestHandler::head(Request request)
 {
-    return send(HeadMethod, request, Body());
+    return send(HeadMethod, std::move(request), Body());
 }
 
 /*!
  * \brief Sends a GET request.
  */
-Response *AbstractRequestHandler::get(const Request &request)
+Response *AbstractRequestHandler::get(Request request)
 {
-    return send(GetMethod, request, Body());
+    return send(GetMethod, std::move(request), Body());
 }
 
 /*!
  * \brief Sends a POST request.
  */
-Response *AbstractRequestHandler::post(const Request &request, const Body &body)
+Response *AbstractRequestHandler::post(Request request, Body body)
 {
-    return send(PostMethod, request, body);
+    return send(PostMethod, std::move(request), std::move(body));
 }
 
 /*!
  * \brief Sends a PUT request.
  */
-Response *AbstractRequestHandler::put(const Request &request, const Body &body)
+Response *AbstractRequestHandler::put(Request request, Body body)
 {
-    return send(PutMethod, request, body);
+    return send(PutMethod, std::move(request), std::move(body));
 }
 
 /*!
  * \brief Sends a PATCH request.
  */
-Response *AbstractRequestHandler::patch(const Request &request, const Body &body)
+Response *AbstractRequestHandler::patch(Request request, Body body)
 {
-    return send(PatchMethod, request, body);
+    return send(PatchMethod, std::move(request), std::move(body));
 }
 
 /*!
  * \brief Sends a DELETE request.
  */
-Response *AbstractRequestHandler::deleteResource(const Request &request)
+Response *AbstractRequestHandler::deleteResource(Request request)
 {
-    return send(DeleteMethod, request, Body());
+    return send(DeleteMethod, std::move(request), Body());
 }
 
-Response *AbstractRequestHandler::send(Method method, const Request &request, const Body &body)
+Response *AbstractRequestHandler::send(Method method, Request request, Body body)
 {
     if (!isRequestSupported(request)) {
         restlinkWarning() << handlerName() << ": trying to send an unsupported request !";
         return nullptr;
     }
 
-    Request finalRequest = request;
-    Body finalBody = body;
-    for (AbstractRequestInterceptor *interceptor : std::as_const(d_ptr->interceptors))
-        interceptor->intercept(method, finalRequest, finalBody);
-    return sendRequest(method, finalRequest, finalBody);
+    return proceed(method, std::move(request), std::move(body), nullptr);
+}
+
+/*!
+ * \brief Runs the interceptor chain from the interceptor following \a after, then sends the request.
+ *
+ * Each interceptor, in the order they were added, first gets its pre-send stage called, then
+ * its short-circuit stage. The first interceptor answering the request stops the chain,
+ * otherwise the request is sent with sendRequest().
+ *
+ * Interceptors that answered a request themselves use this method to continue the chain
+ * later on, passing themselves as \a after, which must still be in the chain. Post response
+ * interceptors are only attached when the chain starts from the beginning, so that they see
+ * each request once, responses already finished when returned are reported right away.
+ *
+ * \param method The HTTP method.
+ * \param request The request to send.
+ * \param body The body to send.
+ * \param after The interceptor after which the chain continues, nullptr to run it entirely.
+ * \return The response, or nullptr on failure.
+ */
+Response *AbstractRequestHandler::proceed(Method method, Request request, Body body, const AbstractRequestInterceptor *after)
+{
+    // No interceptors, no overhead
+    if (!d_ptr->stages && !after)
+        return sendRequest(method, request, body);
+
+    qsizetype index = 0;
+    if (after) {
+        auto it = std::find_if(d_ptr->interceptors.cbegin(), d_ptr->interceptors.cend(), [after](const AbstractRequestHandlerPrivate::Interceptor &entry) {
+            return entry.interceptor == after;
+        });
+
+        // Resuming elsewhere would skip interceptors, or run them twice
+        if (it == d_ptr->interceptors.cend()) {
+            restlinkWarning() << handlerName() << ": can't proceed after an interceptor that isn't in the chain";
+            return nullptr;
+        }
+
+        index = std::distance(d_ptr->interceptors.cbegin(), it) + 1;
+    }
+
+    Response *response = nullptr;
+
+    // Interceptors work on the request and body we own, no copy is made for them
+    const AbstractRequestInterceptor::Stages requestStages = AbstractRequestInterceptor::PreSendStage | AbstractRequestInterceptor::ShortCircuitStage;
+    for (; index < d_ptr->interceptors.size() && !response && d_ptr->stages.testAnyFlags(requestStages); ++index) {
+        const AbstractRequestHandlerPrivate::Interceptor entry = d_ptr->interceptors.at(index);
+
+        if (entry.stages.testFlag(AbstractRequestInterceptor::PreSendStage))
+            entry.interceptor->intercept(method, request, body);
+
+        if (entry.stages.testFlag(AbstractRequestInterceptor::ShortCircuitStage)) {
+            response = entry.interceptor->respond(method, request, body);
+            if (response)
+                initResponse(response, request, method);
+        }
+    }
+
+    if (!response)
+        response = sendRequest(method, request, body);
+
+    if (response && !after && d_ptr->stages.testFlag(AbstractRequestInterceptor::PostResponseStage)) {
+        auto notify = [this, method, response] {
+            for (const AbstractRequestHandlerPrivate::Interceptor &entry : std::as_const(d_ptr->interceptors))
+                if (entry.stages.testFlag(AbstractRequestInterceptor::PostResponseStage))
+                    entry.interceptor->finished(method, response);
+        };
+
+        // Responses completed while being answered have already emitted finished()
+        if (response->isFinished())
+            notify();
+        else
+            QObject::connect(response, &Response::finished, response, notify, Qt::SingleShotConnection);
+    }
+
+    return response;
 }
 
 /*!
@@ -154,16 +231,23 @@ Response *AbstractRequestHandler::send(Method method, const Request &request, co
  */
 QList<AbstractRequestInterceptor *> AbstractRequestHandler::requestInterceptors() const
 {
-    return d_ptr->interceptors;
+    QList<AbstractRequestInterceptor *> interceptors;
+    interceptors.reserve(d_ptr->interceptors.size());
+    for (const AbstractRequestHandlerPrivate::Interceptor &entry : std::as_const(d_ptr->interceptors))
+        interceptors.append(entry.interceptor);
+    return interceptors;
 }
 
 /*!
- * \brief Adds a new request interceptor.
+ * \brief Adds a new request interceptor at the end of the chain.
  */
 void AbstractRequestHandler::addRequestInterceptor(AbstractRequestInterceptor *interceptor)
 {
-    if (!d_ptr->interceptors.contains(interceptor))
-        d_ptr->interceptors.append(interceptor);
+    if (requestInterceptors().contains(interceptor))
+        return;
+
+    d_ptr->interceptors.append({ interceptor, interceptor->stages() });
+    d_ptr->updateStages();
 }
 
 /*!
@@ -171,7 +255,10 @@ void AbstractRequestHandler::addRequestInterceptor(AbstractRequestInterceptor *i
  */
 void AbstractRequestHandler::removeRequestInterceptor(AbstractRequestInterceptor *interceptor)
 {
-    d_ptr->interceptors.removeOne(interceptor);
+    d_ptr->interceptors.removeIf([interceptor](const AbstractRequestHandlerPrivate::Interceptor &entry) {
+        return entry.interceptor == interceptor;
+    });
+    d_ptr->updateStages();
 }
 
 /*!
@@ -179,7 +266,18 @@ void AbstractRequestHandler::removeRequestInterceptor(AbstractRequestInterceptor
  */
 bool AbstractRequestHandler::isRequestSupported(const Request &request) const
 {
-    return supportedSchemes().contains(request.baseUrl().scheme());
+    return isSchemeSupported(request.baseUrl().scheme());
+}
+
+/*!
+ * \brief Checks if \a scheme is supported by this handler.
+ *
+ * The default implementation looks \a scheme up in supportedSchemes(), handlers computing
+ * their schemes on each call should reimplement it with a cheaper lookup.
+ */
+bool AbstractRequestHandler::isSchemeSupported(const QString &scheme) const
+{
+    return supportedSchemes().contains(scheme);
 }
 
 /*!
@@ -193,6 +291,13 @@ void AbstractRequestHandler::initResponse(Response *response, const Request &req
     response->setRequest(request);
 }
 
+void AbstractRequestHandlerPrivate::updateStages()
+{
+    stages = AbstractRequestInterceptor::Stages();
+    for (const Interceptor &entry : std::as_const(interceptors))
+        stages |= entry.stages;
+}
+
 /*!
  * \brief Sends the request using the given method, final request, and body.
  *
@@ -38,13 +38,14 @@ public:
 
     virtual QString handlerName() const;
 
-    Response *head(const Request &request);
-    Response *get(const Request &request);
-    Response *post(const Request &request, const Body &body);
-    Response *put(const Request &request, const Body &body);
-    Response *patch(const Request &request, const Body &body);
-    Response *deleteResource(const Request &request);
-    Response *send(Method method, const Request &request, const Body &body);
+    Response *head(Request request);
+    Response *get(Request request);
+    Response *post(Request request, Body body);
+    Response *put(Request request, Body body);
+    Response *patch(Request request, Body body);
+    Response *deleteResource(Request request);
+    Response *send(Method method, Request request, Body body);
+    Response *proceed(Method method, Request request, Body body, const AbstractRequestInterceptor *after);
 
     QList<AbstractRequestInterceptor *> requestInterceptors() const;
     void addRequestInterceptor(AbstractRequestInterceptor *interceptor);
@@ -55,8 +56,10 @@ public:
 
 protected:
     AbstractRequestHandler();
+    AbstractRequestHandler(AbstractRequestHandlerPrivate *d);
 
     bool isRequestSupported(const Request &request) const;
+    virtual bool isSchemeSupported(const QString &scheme) const;
     void initResponse(Response *response, const Request &request, Method method);
     virtual Response *sendRequest(Method method, const Request &request, const Body &body) = 0;
 
@@ -3,6 +3,8 @@
 
 #include "abstractrequesthandler.h"
 
+#include <RestLink/abstractrequestinterceptor.h>
+
 #include <QtCore/qlist.h>
 
 namespace RestLink {
@@ -10,9 +12,17 @@ namespace RestLink {
 class AbstractRequestHandlerPrivate
 {
 public:
+    struct Interceptor {
+        AbstractRequestInterceptor *interceptor;
+        AbstractRequestInterceptor::Stages stages;
+    };
+
     virtual ~AbstractRequestHandlerPrivate() = default;
 
-    QList<AbstractRequestInterceptor *> interceptors;
+    void updateStages();
+
+    QList<Interceptor> interceptors;
+    AbstractRequestInterceptor::Stages stages; // All stages in use, spares the chain walk when unused
 };
 
 }
@@ -23,8 +23,32 @@ namespace RestLink {
  */
 
 /**
- * @fn AbstractRequestInterceptor::intercept(RequestHandler::Method method, Request &request, Body &body)
+ * @enum AbstractRequestInterceptor::Stage
  *
+ * @brief Stages of the interceptor chain an interceptor takes part in.
+ *
+ * @var AbstractRequestInterceptor::PreSendStage
+ * intercept() is called before the request is sent.
+ * @var AbstractRequestInterceptor::ShortCircuitStage
+ * respond() is called and may answer the request instead of the handler.
+ * @var AbstractRequestInterceptor::PostResponseStage
+ * finished() is called once the response is finished.
+ */
+
+/**
+ * @brief Returns the stages this interceptor takes part in.
+ *
+ * Handlers only call the hooks of the stages returned here, so that unused stages cost nothing.
+ * The value is read once, when the interceptor is added to a handler, and must not change afterwards.
+ *
+ * The default implementation returns PreSendStage.
+ */
+AbstractRequestInterceptor::Stages AbstractRequestInterceptor::stages() const
+{
+    return PreSendStage;
+}
+
+/**
  * @brief Called before a request is sent, allowing modification of both request and body.
  *
  * Use this method to alter the HTTP method, headers, URL, or the body content prior to transmission.
@@ -33,6 +57,48 @@ namespace RestLink {
  * @param request The request object to be modified.
  * @param body The body associated with the request, which can also be modified.
  */
+void AbstractRequestInterceptor::intercept(AbstractRequestHandler::Method method, Request &request, Body &body)
+{
+    Q_UNUSED(method);
+    Q_UNUSED(request);
+    Q_UNUSED(body);
+}
+
+/**
+ * @brief Gives the interceptor a chance to answer the request itself.
+ *
+ * Returning a response stops the chain, the request is not sent and interceptors that come
+ * later aren't called, except on the post response stage. This is meant for mocking, local
+ * caches or any kind of asynchronous work that must happen before sending: return a response
+ * you control, for example a DeferredResponse, and complete it later, possibly after calling
+ * AbstractRequestHandler::proceed() to continue the chain.
+ *
+ * The returned response must not be finished yet, as callers connect to its finished() signal.
+ *
+ * @param method The HTTP method.
+ * @param request The request about to be sent.
+ * @param body The body associated with the request.
+ * @return A response answering the request, or nullptr to let the request continue.
+ */
+Response *AbstractRequestInterceptor::respond(AbstractRequestHandler::Method method, const Request &request, const Body &body)
+{
+    Q_UNUSED(method);
+    Q_UNUSED(request);
+    Q_UNUSED(body);
+    return nullptr;
+}
+
+/**
+ * @brief Called once a response is finished, whether it came from the network or from an interceptor.
+ *
+ * @param method The HTTP method of the request.
+ * @param response The finished response.
+ */
+void AbstractRequestInterceptor::finished(AbstractRequestHandler::Method method, Response *response)
+{
+    Q_UNUSED(method);
+    Q_UNUSED(response);
+}
 
 /**
  * @class LogRequestInterceptor
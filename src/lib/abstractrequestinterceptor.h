@@ -11,9 +11,20 @@ namespace RestLink {
 class RESTLINK_EXPORT AbstractRequestInterceptor
 {
 public:
+    enum Stage {
+        PreSendStage = 0x1,
+        ShortCircuitStage = 0x2,
+        PostResponseStage = 0x4
+    };
+    Q_DECLARE_FLAGS(Stages, Stage)
+
     virtual ~AbstractRequestInterceptor() = default;
 
-    virtual void intercept(AbstractRequestHandler::Method method, Request &request, Body &body) = 0;
+    virtual Stages stages() const;
+
+    virtual void intercept(AbstractRequestHandler::Method method, Request &request, Body &body);
+    virtual Response *respond(AbstractRequestHandler::Method method, const Request &request, const Body &body);
+    virtual void finished(AbstractRequestHandler::Method method, Response *response);
 };
 
 class RESTLINK_EXPORT LogRequestInterceptor : public AbstractRequestInterceptor
@@ -32,4 +43,6 @@ private:
 
 }
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(RestLink::AbstractRequestInterceptor::Stages)
+
 #endif // RESTLINK_ABSTRACTREQUESTINTERCEPTOR_H
@@ -0,0 +1,314 @@
+#include "abstracttokenprovider.h"
+#include "abstracttokenprovider_p.h"
+
+#include <RestLink/api.h>
+#include <RestLink/header.h>
+#include <RestLink/response.h>
+#include <RestLink/deferredresponse.h>
+#include <RestLink/networkmanager.h>
+
+#include <QtCore/qsharedpointer.h>
+
+#include <limits>
+
+namespace RestLink {
+
+/*!
+ * \class RestLink::AbstractTokenProvider
+ * \brief Supplies bearer tokens to an Api and keeps them fresh.
+ *
+ * Subclasses implement fetchToken() to obtain a new token, typically through an OAuth2
+ * refresh token grant, and report the outcome with setToken() or failRefresh().
+ *
+ * Refreshes are single flight: refresh() does nothing while a refresh is running, however many
+ * requests are waiting for it. Tokens with an expiry are refreshed refreshMargin() seconds
+ * before they expire.
+ *
+ * Once set on an Api with Api::setTokenProvider(), requests issued while a refresh is running
+ * are parked and sent once the new token is there. A request answered with HTTP 401 triggers
+ * a refresh, unless another request already did so, and is replayed once with the new token.
+ *
+ * \sa Api::setTokenProvider()
+ */
+
+/*!
+ * \fn void AbstractTokenProvider::fetchToken()
+ * \brief Starts fetching a new token.
+ *
+ * The implementation may work asynchronously, it must call setToken() on success or
+ * failRefresh() on failure.
+ */
+
+AbstractTokenProvider::AbstractTokenProvider(QObject *parent)
+    : QObject(parent)
+    , d_ptr(new AbstractTokenProviderPrivate(this))
+{
+    RESTLINK_D(AbstractTokenProvider);
+    d->refreshTimer.setSingleShot(true);
+    connect(&d->refreshTimer, &QTimer::timeout, this, [this] {
+        RESTLINK_D(AbstractTokenProvider);
+        if (needsRefresh())
+            refresh();
+        else
+            d->scheduleRefresh();
+    });
+}
+
+AbstractTokenProvider::~AbstractTokenProvider()
+{
+}
+
+/*!
+ * \brief Returns the current token, empty if none was obtained yet.
+ */
+QString AbstractTokenProvider::token() const
+{
+    RESTLINK_D(const AbstractTokenProvider);
+    return d->token;
+}
+
+/*!
+ * \brief Returns the expiry date of the current token, invalid if it doesn't expire.
+ */
+QDateTime AbstractTokenProvider::expiry() const
+{
+    RESTLINK_D(const AbstractTokenProvider);
+    return d->expiry;
+}
+
+/*!
+ * \brief Returns true if there is no token yet or if it's about to expire.
+ */
+bool AbstractTokenProvider::needsRefresh() const
+{
+    RESTLINK_D(const AbstractTokenProvider);
+    if (d->token.isEmpty())
+        return true;
+
+    return d->expiry.isValid() && QDateTime::currentDateTimeUtc().addSecs(d->refreshMargin) >= d->expiry;
+}
+
+/*!
+ * \brief Returns how many seconds before expiry tokens get refreshed, 60 by default.
+ */
+int AbstractTokenProvider::refreshMargin() const
+{
+    RESTLINK_D(const AbstractTokenProvider);
+    return d->refreshMargin;
+}
+
+void AbstractTokenProvider::setRefreshMargin(int seconds)
+{
+    RESTLINK_D(AbstractTokenProvider);
+    d->refreshMargin = seconds;
+    d->scheduleRefresh();
+}
+
+/*!
+ * \brief Returns true while a refresh is running.
+ */
+bool AbstractTokenProvider::isRefreshing() const
+{
+    RESTLINK_D(const AbstractTokenProvider);
+    return d->refreshing;
+}
+
+/*!
+ * \brief Starts a refresh, unless one is already running.
+ */
+void AbstractTokenProvider::refresh()
+{
+    RESTLINK_D(AbstractTokenProvider);
+    if (d->refreshing)
+        return;
+
+    d->refreshing = true;
+    d->refreshTimer.stop();
+    emit refreshingChanged(true);
+
+    fetchToken();
+}
+
+/*!
+ * \brief Sets the new token and its \a expiry, ending the running refresh if any.
+ */
+void AbstractTokenProvider::setToken(const QString &token, const QDateTime &expiry)
+{
+    RESTLINK_D(AbstractTokenProvider);
+
+    const bool changed = (d->token != token);
+    d->token = token;
+    d->expiry = expiry.toUTC();
+    d->scheduleRefresh();
+
+    if (changed)
+        emit tokenChanged(token);
+
+    if (d->refreshing) {
+        d->refreshing = false;
+        emit refreshingChanged(false);
+        emit refreshFinished(true);
+    }
+}
+
+/*!
+ * \brief Ends the running refresh as failed, the current token is kept.
+ */
+void AbstractTokenProvider::failRefresh()
+{
+    RESTLINK_D(AbstractTokenProvider);
+    if (!d->refreshing)
+        return;
+
+    d->refreshing = false;
+    emit refreshingChanged(false);
+    emit refreshFinished(false);
+}
+
+AbstractTokenProviderPrivate::AbstractTokenProviderPrivate(AbstractTokenProvider *q)
+    : q_ptr(q)
+    , refreshMargin(60)
+    , refreshing(false)
+{
+}
+
+void AbstractTokenProviderPrivate::scheduleRefresh()
+{
+    if (!expiry.isValid() || token.isEmpty()) {
+        refreshTimer.stop();
+        return;
+    }
+
+    // Far away expiries are rescheduled when the timer fires
+    const qint64 delay = QDateTime::currentDateTimeUtc().msecsTo(expiry) - qint64(refreshMargin) * 1000;
+    refreshTimer.start(int(qBound<qint64>(0, delay, std::numeric_limits<int>::max())));
+}
+
+TokenInterceptor::TokenInterceptor(Api *api, AbstractTokenProvider *provider, NetworkManager *manager)
+    : QObject(api)
+    , m_api(api)
+    , m_provider(provider)
+    , m_manager(manager)
+{
+    connect(provider, &AbstractTokenProvider::refreshFinished, this, &TokenInterceptor::replay);
+}
+
+TokenInterceptor::~TokenInterceptor()
+{
+    if (m_manager)
+        m_manager->removeRequestInterceptor(this);
+
+    // Parked requests would never be sent otherwise
+    const QList<PendingRequest> requests = std::exchange(m_parkedRequests, {});
+    for (const PendingRequest &request : requests)
+        if (request.response)
+            request.response->abort();
+}
+
+AbstractRequestInterceptor::Stages TokenInterceptor::stages() const
+{
+    return ShortCircuitStage;
+}
+
+Response *TokenInterceptor::respond(AbstractRequestHandler::Method method, const Request &request, const Body &body)
+{
+    if (!m_provider || request.api() != m_api)
+        return nullptr;
+
+    DeferredResponse *response = new DeferredResponse(method, m_api);
+
+    const PendingRequest pending = { response, method, request, body, false };
+    if (m_provider->needsRefresh())
+        park(pending);
+    else
+        dispatch(pending);
+
+    return response;
+}
+
+void TokenInterceptor::park(const PendingRequest &request)
+{
+    m_parkedRequests.append(request);
+    m_provider->refresh();
+}
+
+void TokenInterceptor::dispatch(PendingRequest pending)
+{
+    if (!pending.response || pending.response->isAborted() || !m_manager)
+        return;
+
+    const QString token = (m_provider ? m_provider->token() : QString());
+    if (!token.isEmpty())
+        pending.request.setHeader(Header(QHttpHeaders::WellKnownHeader::Authorization, "Bearer " + token));
+
+    Response *response = m_manager->proceed(pending.method, pending.request, pending.body, this);
+    if (!response) {
+        pending.response->abort();
+        return;
+    }
+
+    // Replays, and first attempts known not to be 401s, go straight to the caller
+    if (pending.retried || !m_provider) {
+        pending.response->setTarget(response);
+        return;
+    }
+
+    // The status is known once data arrives or the attempt finishes, a 401 never reaches the caller
+    QSharedPointer<bool> decided = QSharedPointer<bool>::create(false);
+    auto decide = [this, pending, response, token, decided] {
+        if (*decided)
+            return;
+
+        if (!pending.response || pending.response->isAborted()) {
+            *decided = true;
+            response->abort();
+            response->deleteLater();
+            return;
+        }
+
+        if (response->httpStatusCode() != 401 || !m_provider) {
+            *decided = true;
+            pending.response->setTarget(response);
+            return;
+        }
+
+        // The 401 body is dropped with the attempt, the retry answers the caller
+        if (!response->isFinished())
+            return;
+
+        *decided = true;
+        response->deleteLater();
+
+        PendingRequest retry = pending;
+        retry.retried = true;
+
+        // Another request may have refreshed the token in the meantime
+        if (m_provider->token() != token && !m_provider->isRefreshing())
+            dispatch(retry);
+        else
+            park(retry);
+    };
+
+    if (response->isFinished() || response->bytesAvailable() > 0) {
+        decide();
+        if (*decided)
+            return;
+    }
+
+    connect(response, &QIODevice::readyRead, this, decide);
+    connect(response, &Response::finished, this, decide);
+    connect(pending.response, &Response::finished, this, decide);
+}
+
+void TokenInterceptor::replay(bool refreshed)
+{
+    const QList<PendingRequest> requests = std::exchange(m_parkedRequests, {});
+    for (PendingRequest request : requests) {
+        // Without a new token, the server answer is given as is
+        if (!refreshed)
+            request.retried = true;
+        dispatch(request);
+    }
+}
+
+} // namespace RestLink
@@ -0,0 +1,49 @@
+#ifndef RESTLINK_ABSTRACTTOKENPROVIDER_H
+#define RESTLINK_ABSTRACTTOKENPROVIDER_H
+
+#include <RestLink/global.h>
+
+#include <QtCore/qobject.h>
+#include <QtCore/qdatetime.h>
+
+namespace RestLink {
+
+class AbstractTokenProviderPrivate;
+class RESTLINK_EXPORT AbstractTokenProvider : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(QString token READ token NOTIFY tokenChanged FINAL)
+    Q_PROPERTY(bool refreshing READ isRefreshing NOTIFY refreshingChanged FINAL)
+
+public:
+    explicit AbstractTokenProvider(QObject *parent = nullptr);
+    ~AbstractTokenProvider();
+
+    QString token() const;
+    QDateTime expiry() const;
+    bool needsRefresh() const;
+
+    int refreshMargin() const;
+    void setRefreshMargin(int seconds);
+
+    bool isRefreshing() const;
+    Q_SLOT void refresh();
+
+signals:
+    void tokenChanged(const QString &token);
+    void refreshingChanged(bool refreshing);
+    void refreshFinished(bool success);
+
+protected:
+    virtual void fetchToken() = 0;
+
+    void setToken(const QString &token, const QDateTime &expiry = QDateTime());
+    void failRefresh();
+
+private:
+    QScopedPointer<AbstractTokenProviderPrivate> d_ptr;
+};
+
+} // namespace RestLink
+
+#endif // RESTLINK_ABSTRACTTOKENPROVIDER_H
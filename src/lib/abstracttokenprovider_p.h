@@ -0,0 +1,67 @@
+#ifndef RESTLINK_ABSTRACTTOKENPROVIDER_P_H
+#define RESTLINK_ABSTRACTTOKENPROVIDER_P_H
+
+#include "abstracttokenprovider.h"
+
+#include <RestLink/abstractrequestinterceptor.h>
+#include <RestLink/request.h>
+#include <RestLink/body.h>
+
+#include <QtCore/qtimer.h>
+#include <QtCore/qpointer.h>
+
+namespace RestLink {
+
+class Api;
+class NetworkManager;
+class DeferredResponse;
+
+class AbstractTokenProviderPrivate
+{
+public:
+    AbstractTokenProviderPrivate(AbstractTokenProvider *q);
+
+    void scheduleRefresh();
+
+    AbstractTokenProvider *q_ptr;
+
+    QString token;
+    QDateTime expiry;
+    int refreshMargin;
+    bool refreshing;
+
+    QTimer refreshTimer;
+};
+
+// Answers Api requests with deferred responses, so that they can wait for a token refresh
+class TokenInterceptor : public QObject, public AbstractRequestInterceptor
+{
+public:
+    TokenInterceptor(Api *api, AbstractTokenProvider *provider, NetworkManager *manager);
+    ~TokenInterceptor();
+
+    Stages stages() const override;
+    Response *respond(AbstractRequestHandler::Method method, const Request &request, const Body &body) override;
+
+private:
+    struct PendingRequest {
+        QPointer<DeferredResponse> response;
+        AbstractRequestHandler::Method method;
+        Request request;
+        Body body;
+        bool retried;
+    };
+
+    void park(const PendingRequest &request);
+    void dispatch(PendingRequest request);
+    void replay(bool refreshed);
+
+    Api *m_api;
+    QPointer<AbstractTokenProvider> m_provider;
+    QPointer<NetworkManager> m_manager;
+    QList<PendingRequest> m_parkedRequests;
+};
+
+} // namespace RestLink
+
+#endif // RESTLINK_ABSTRACTTOKENPROVIDER_P_H
@@ -14,6 +14,8 @@
 #include <RestLink/request.h>
 #include <RestLink/response.h>
 #include <RestLink/networkmanager.h>
+#include <RestLink/abstracttokenprovider.h>
+#include <RestLink/private/abstracttokenprovider_p.h>
 
 namespace RestLink {
 
@@ -71,6 +73,7 @@ Api::Api(QObject *parent) :
     ApiBase(new ApiPrivate(this), parent)
 {
     d_ptr->internalRequestData->api = this;
+    d_ptr->publishRequestData();
 }
 
 Api::~Api()
@@ -197,6 +200,50 @@ void Api::setBearerToken(const QString &token)
     }
 }
 
+/*!
+ * \brief Returns the token provider keeping the bearer token fresh, nullptr if none.
+ */
+AbstractTokenProvider *Api::tokenProvider() const
+{
+    RESTLINK_D(const Api);
+    return d->tokenProvider;
+}
+
+/*!
+ * \brief Sets the \a provider keeping the bearer token of this Api fresh.
+ *
+ * The bearer token follows the provider's token. Requests sent while the token is being
+ * refreshed wait for the new one, and requests answered with HTTP 401 are replayed once
+ * after a refresh. The provider is not owned by the Api.
+ *
+ * \note The provider hooks into the current network manager, set it after setNetworkManager().
+ * Per-thread network managers don't wait for refreshes nor replay requests, see setNetworkManagerPolicy().
+ * \sa AbstractTokenProvider
+ */
+void Api::setTokenProvider(AbstractTokenProvider *provider)
+{
+    RESTLINK_D(Api);
+    if (d->tokenProvider == provider)
+        return;
+
+    if (d->tokenProvider)
+        disconnect(d->tokenProvider, nullptr, this, nullptr);
+
+    delete d->tokenInterceptor;
+    d->tokenInterceptor = nullptr;
+
+    d->tokenProvider = provider;
+    if (!provider)
+        return;
+
+    d->tokenInterceptor = new TokenInterceptor(this, provider, networkManager());
+    networkManager()->addRequestInterceptor(d->tokenInterceptor);
+
+    connect(provider, &AbstractTokenProvider::tokenChanged, this, &Api::setBearerToken);
+    if (!provider->token().isEmpty())
+        setBearerToken(provider->token());
+}
+
 /*!
  * \brief Returns the user agent for the API.
  *
@@ -294,6 +341,7 @@ bool Api::configure(const QJsonObject &config)
     d_ptr->internalRequestData->pathParameters = data->pathParameters;
     d_ptr->internalRequestData->queryParameters = data->queryParameters;
     d_ptr->internalRequestData->headers = data->headers;
+    d_ptr->publishRequestData();
 
     d->remoteRequests.clear();
     if (config.contains("requests")) {
@@ -312,19 +360,22 @@ bool Api::configure(const QJsonObject &config)
     return true;
 }
 
-Response *Api::send(AbstractRequestHandler::Method method, const Request &request, const Body &body)
+Response *Api::send(AbstractRequestHandler::Method method, Request request, Body body)
 {
     RESTLINK_D(Api);
-    if (d->hasRemoteRequest(request))
-        return ApiBase::send(method, Request::merge(request, d->remoteRequest(request)), body);
-    else
-        return ApiBase::send(method, request, body);
+    if (d->hasRemoteRequest(request)) {
+        const Request remoteRequest = d->remoteRequest(request);
+        return ApiBase::send(method, Request::merge(std::move(request), remoteRequest), std::move(body));
+    } else {
+        return ApiBase::send(method, std::move(request), std::move(body));
+    }
 }
 
 ApiPrivate::ApiPrivate(Api *qq) :
     ApiBasePrivate(qq),
     version(0),
     locale(QLocale::system()),
+    tokenInterceptor(nullptr),
     userAgent(QStringLiteral("libRestLink/") + QStringLiteral(RESTLINK_VERSION_STR))
 {
 #ifndef QT_NO_SSL
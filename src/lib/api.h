@@ -10,6 +10,8 @@
 
 namespace RestLink {
 
+class AbstractTokenProvider;
+
 class ApiPrivate;
 class RESTLINK_EXPORT Api : public ApiBase
 {
@@ -45,6 +47,9 @@ public:
     Q_SLOT void setBearerToken(const QString &token);
     Q_SIGNAL void bearerTokenChanged(const QString &token);
 
+    AbstractTokenProvider *tokenProvider() const;
+    void setTokenProvider(AbstractTokenProvider *provider);
+
     QString userAgent() const override;
     Q_SLOT void setUserAgent(const QString &agent);
     Q_SIGNAL void userAgentChanged(const QString &agent);
@@ -54,7 +59,7 @@ public:
     Q_SIGNAL void configurationCompleted();
     Q_SIGNAL void configurationFailed();
 
-    Response *send(AbstractRequestHandler::Method method, const Request &request, const Body &body) override;
+    Response *send(AbstractRequestHandler::Method method, Request request, Body body) override;
 
 private:
     inline QString versionString() const
@@ -7,8 +7,13 @@
 
 #include "apibase_p.h"
 
+#include <QtCore/qpointer.h>
+
 namespace RestLink {
 
+class AbstractTokenProvider;
+class TokenInterceptor;
+
 class ApiPrivate : public ApiBasePrivate
 {
 public:
@@ -31,6 +36,8 @@ public:
 
     QLocale locale;
     QString bearerToken;
+    QPointer<AbstractTokenProvider> tokenProvider;
+    TokenInterceptor *tokenInterceptor;
 
     QString userAgent;
 
@@ -6,7 +6,13 @@
 #include <RestLink/body.h>
 #include <RestLink/response.h>
 #include <RestLink/networkmanager.h>
+#include <RestLink/cookiejar.h>
+#include <RestLink/cache.h>
+#include <RestLink/abstractrequestinterceptor.h>
 #include <RestLink/private/request_p.h>
+#include <RestLink/private/cache_p.h>
+
+#include <QtCore/qthread.h>
 
 namespace RestLink {
 
@@ -55,9 +61,9 @@ QLocale ApiBase::locale() const
  * @param request The Request object to be sent.
  * @param callback The callback function to be invoked once the request completes.
  */
-void ApiBase::head(const Request &request, const ApiRunCallback &callback)
+void ApiBase::head(Request request, const ApiRunCallback &callback)
 {
-    Response *response = head(request);
+    Response *response = head(std::move(request));
     connect(response, &Response::finished, this, [callback, response] { callback(response); });
     connect(response, &Response::finished, response, &QObject::deleteLater);
 }
@@ -68,9 +74,9 @@ void ApiBase::head(const Request &request, const ApiRunCallback &callback)
  * @param request The Request object to be sent.
  * @return A Response object containing the result of the HEAD request.
  */
-Response *ApiBase::head(const Request &request)
+Response *ApiBase::head(Request request)
 {
-    return send(AbstractRequestHandler::HeadMethod, request, Body());
+    return send(AbstractRequestHandler::HeadMethod, std::move(request), Body());
 }
 
 /**
@@ -79,9 +85,9 @@ Response *ApiBase::head(const Request &request)
  * @param request The Request object to be sent.
  * @param callback The callback function to be invoked once the request completes.
  */
-void ApiBase::get(const Request &request, const ApiRunCallback &callback)
+void ApiBase::get(Request request, const ApiRunCallback &callback)
 {
-    Response *response = get(request);
+    Response *response = get(std::move(request));
     connect(response, &Response::finished, this, [callback, response] { callback(response); });
     connect(response, &Response::finished, response, &QObject::deleteLater);
 }
@@ -92,9 +98,9 @@ void ApiBase::get(const Request &request, const ApiRunCallback &callback)
  * @param request The Request object to be sent.
  * @return A Response object containing the result of the GET request.
  */
-Response *ApiBase::get(const Request &request)
+Response *ApiBase::get(Request request)
 {
-    return send(AbstractRequestHandler::GetMethod, request, Body());
+    return send(AbstractRequestHandler::GetMethod, std::move(request), Body());
 }
 
 /**
@@ -104,9 +110,9 @@ Response *ApiBase::get(const Request &request)
  * @param body The Body object containing the data to be sent in the request.
  * @param callback The callback function to be invoked once the request completes.
  */
-void ApiBase::post(const Request &request, const Body &body, const ApiRunCallback &callback)
+void ApiBase::post(Request request, Body body, const ApiRunCallback &callback)
 {
-    Response *response = post(request, body);
+    Response *response = post(std::move(request), std::move(body));
     connect(response, &Response::finished, this, [callback, response] { callback(response); });
     connect(response, &Response::finished, response, &QObject::deleteLater);
 }
@@ -118,9 +124,9 @@ void ApiBase::post(const Request &request, const Body &body, const ApiRunCallbac
  * @param body The Body object containing the data to be sent in the request.
  * @return A Response object containing the result of the POST request.
  */
-Response *ApiBase::post(const Request &request, const Body &body)
+Response *ApiBase::post(Request request, Body body)
 {
-    return send(AbstractRequestHandler::PostMethod, request, body);
+    return send(AbstractRequestHandler::PostMethod, std::move(request), std::move(body));
 }
 
 /**
@@ -130,9 +136,9 @@ Response *ApiBase::post(const Request &request, const Body &body)
  * @param body The Body object containing the data to be sent in the request.
  * @param callback The callback function to be invoked once the request completes.
  */
-void ApiBase::put(const Request &request, const Body &body, const ApiRunCallback &callback)
+void ApiBase::put(Request request, Body body, const ApiRunCallback &callback)
 {
-    Response *response = put(request, body);
+    Response *response = put(std::move(request), std::move(body));
     connect(response, &Response::finished, this, [callback, response] { callback(response); });
     connect(response, &Response::finished, response, &QObject::deleteLater);
 }
@@ -144,9 +150,9 @@ void ApiBase::put(const Request &request, const Body &body, const ApiRunCallback
  * @param body The Body object containing the data to be sent in the request.
  * @return A Response object containing the result of the PUT request.
  */
-Response *ApiBase::put(const Request &request, const Body &body)
+Response *ApiBase::put(Request request, Body body)
 {
-    return send(AbstractRequestHandler::PutMethod, request, body);
+    return send(AbstractRequestHandler::PutMethod, std::move(request), std::move(body));
 }
 
 /**
@@ -156,9 +162,9 @@ Response *ApiBase::put(const Request &request, const Body &body)
  * @param body The Body object containing the data to be sent in the request.
  * @param callback The callback function to be invoked once the request completes.
  */
-void ApiBase::patch(const Request &request, const Body &body, const ApiRunCallback &callback)
+void ApiBase::patch(Request request, Body body, const ApiRunCallback &callback)
 {
-    Response *response = patch(request, body);
+    Response *response = patch(std::move(request), std::move(body));
     connect(response, &Response::finished, this, [callback, response] { callback(response); });
     connect(response, &Response::finished, response, &QObject::deleteLater);
 }
@@ -170,9 +176,9 @@ void ApiBase::patch(const Request &request, const Body &body, const ApiRunCallba
  * @param body The Body object containing the data to be sent in the request.
  * @return A Response object containing the result of the PATCH request.
  */
-Response *ApiBase::patch(const Request &request, const Body &body)
+Response *ApiBase::patch(Request request, Body body)
 {
-    return send(AbstractRequestHandler::PatchMethod, request, body);
+    return send(AbstractRequestHandler::PatchMethod, std::move(request), std::move(body));
 }
 
 /**
@@ -181,9 +187,9 @@ Response *ApiBase::patch(const Request &request, const Body &body)
  * @param request The Request object to be sent.
  * @param callback The callback function to be invoked once the request completes.
  */
-void ApiBase::deleteResource(const Request &request, const ApiRunCallback &callback)
+void ApiBase::deleteResource(Request request, const ApiRunCallback &callback)
 {
-    Response *response = deleteResource(request);
+    Response *response = deleteResource(std::move(request));
     connect(response, &Response::finished, this, [callback, response] { callback(response); });
     connect(response, &Response::finished, response, &QObject::deleteLater);
 }
@@ -194,19 +200,22 @@ void ApiBase::deleteResource(const Request &request, const ApiRunCallback &callb
  * @param request The Request object to be sent.
  * @return A Response object containing the result of the DELETE request.
  */
-Response *ApiBase::deleteResource(const Request &request)
+Response *ApiBase::deleteResource(Request request)
 {
-    return send(AbstractRequestHandler::DeleteMethod, request, Body());
+    return send(AbstractRequestHandler::DeleteMethod, std::move(request), Body());
 }
 
-Response *ApiBase::send(AbstractRequestHandler::Method method, const Request &request, const Body &body)
+Response *ApiBase::send(AbstractRequestHandler::Method method, Request request, Body body)
 {
-    // Preprocessing request by adding api url parameters and headers
-    Request finalRequest = Request::merge(request, Request(d_ptr->internalRequestData));
+    // Other threads only see published parameters and headers, the api thread may be changing them
+    const Request apiRequest = (QThread::currentThread() == thread() ? Request(d_ptr->internalRequestData) : d_ptr->publishedRequest());
+
+    // Preprocessing request by adding api url parameters and headers, in place when the request isn't shared
+    Request finalRequest = Request::merge(std::move(request), apiRequest);
     finalRequest.setApi(d_ptr->internalRequestData->api);
 
     // Sending request and return response
-    return d_ptr->networkManager()->send(method, finalRequest, body);
+    return d_ptr->networkManager()->send(method, std::move(finalRequest), std::move(body));
 }
 
 /**
@@ -223,6 +232,7 @@ QString ApiBase::userAgent() const
  * @brief Returns the network manager used by the ApiBase class.
  *
  * This function retrieves the current instance of the QNetworkAccessManager that is used for making network requests.
+ * With the PerThreadNetworkManager policy, threads other than the api one get their own network manager.
  *
  * @return A pointer to the QNetworkAccessManager instance.
  */
@@ -241,6 +251,46 @@ NetworkManager *ApiBase::networkManager() const
 void ApiBase::setNetworkManager(NetworkManager *manager)
 {
     d_ptr->setNetworkManager(manager);
+
+    if (d_ptr->networkManagerPolicy == PerThreadNetworkManager)
+        d_ptr->captureSharedConfiguration();
+}
+
+/**
+ * @brief Returns how network managers are shared between threads.
+ */
+ApiBase::NetworkManagerPolicy ApiBase::networkManagerPolicy() const
+{
+    return d_ptr->networkManagerPolicy;
+}
+
+/**
+ * @brief Sets how network managers are shared between threads.
+ *
+ * With SharedNetworkManager, the default, every request goes through the network manager living
+ * in the api thread. With PerThreadNetworkManager, requests sent from other threads go through
+ * a network manager created for each thread, so that they don't have to be marshalled to the
+ * api thread. The calling thread must run an event loop for its responses to progress.
+ *
+ * Per-thread network managers start with the cookie jar, cache, redirect policy, transfer timeout
+ * and request interceptors of the main network manager, as they are when this method is called.
+ * RestLink cookie jars and caches lock their state so they can be shared, other ones are not shared,
+ * interceptors living in another thread are not shared either.
+ *
+ * @note The api headers and parameters must be changed from the api thread, other threads merge
+ * the latest snapshot of them into their requests.
+ */
+void ApiBase::setNetworkManagerPolicy(NetworkManagerPolicy policy)
+{
+    d_ptr->networkManagerPolicy = policy;
+
+    if (policy == PerThreadNetworkManager)
+        d_ptr->captureSharedConfiguration();
+}
+
+void ApiBase::parametersChanged()
+{
+    d_ptr->publishRequestData();
 }
 
 const QList<PathParameter> *ApiBase::constPathParameters() const
@@ -276,24 +326,118 @@ QList<Header> *ApiBase::mutableHeaders()
 ApiBasePrivate::ApiBasePrivate(ApiBase *q)
     : q_ptr(q)
     , internalRequestData(new RequestPrivate())
+    , networkManagerPolicy(ApiBase::SharedNetworkManager)
+    , id([] { static QAtomicInteger<quint64> ids; return ids.fetchAndAddRelaxed(1); }())
     , m_networkManager(nullptr)
 {
     internalRequestData->ref.ref();
+    publishRequestData();
 }
 
 ApiBasePrivate::~ApiBasePrivate()
 {
+    // Per-thread managers go away in their own thread
+    QMutexLocker locker(&threadManagersMutex);
+    for (const QPointer<NetworkManager> &manager : std::as_const(threadManagers))
+        if (manager)
+            manager->deleteLater();
+    locker.unlock();
+
     if (!internalRequestData->ref.deref())
         delete internalRequestData;
 }
 
 NetworkManager *ApiBasePrivate::networkManager() const
+{
+    if (networkManagerPolicy == ApiBase::PerThreadNetworkManager && QThread::currentThread() != q_ptr->thread())
+        return threadNetworkManager();
+    return mainNetworkManager();
+}
+
+NetworkManager *ApiBasePrivate::mainNetworkManager() const
 {
     if (!m_networkManager)
         m_networkManager = new NetworkManager(q_ptr);
     return m_networkManager;
 }
 
+NetworkManager *ApiBasePrivate::threadNetworkManager() const
+{
+    // No lock on lookups, each thread has its own managers
+    static thread_local QHash<quint64, QPointer<NetworkManager>> managers;
+    QPointer<NetworkManager> &manager = managers[id];
+    if (manager)
+        return manager;
+
+    QMutexLocker locker(&threadManagersMutex);
+    const SharedConfiguration configuration = sharedConfiguration;
+    locker.unlock();
+
+    // The api lives in another thread, it can't be the parent
+    manager = new NetworkManager();
+    manager->setRedirectPolicy(configuration.redirectPolicy);
+    manager->setTransferTimeout(configuration.transferTimeout);
+
+    // The cookie jar and the cache stay owned by the main manager, the manager would take a cache it's given
+    if (configuration.cookieJar)
+        manager->setCookieJar(configuration.cookieJar);
+    if (configuration.cache)
+        manager->setCache(new CacheProxy(configuration.cache));
+
+    for (AbstractRequestInterceptor *interceptor : configuration.interceptors)
+        manager->addRequestInterceptor(interceptor);
+
+    // Released when the thread finishes, deferred deletions are processed then
+    QThread *thread = QThread::currentThread();
+    QObject::connect(thread, &QThread::finished, manager, &QObject::deleteLater, Qt::DirectConnection);
+
+    // Managers deleted by their thread drop their entry, the table of other threads can't be reached
+    QObject::connect(manager, &QObject::destroyed, [key = id, thread] {
+        if (QThread::currentThread() == thread)
+            managers.remove(key);
+    });
+
+    locker.relock();
+    threadManagers.removeAll(nullptr);
+    threadManagers.append(manager);
+    return manager;
+}
+
+void ApiBasePrivate::captureSharedConfiguration()
+{
+    NetworkManager *manager = mainNetworkManager();
+
+    SharedConfiguration configuration;
+    configuration.cookieJar = qobject_cast<CookieJar *>(manager->cookieJar());
+    configuration.cache = qobject_cast<Cache *>(manager->cache());
+    configuration.redirectPolicy = manager->redirectPolicy();
+    configuration.transferTimeout = manager->transferTimeout();
+
+    // Interceptors bound to a thread, like QObject based ones, can't be shared
+    const QList<AbstractRequestInterceptor *> interceptors = manager->requestInterceptors();
+    for (AbstractRequestInterceptor *interceptor : interceptors)
+        if (!dynamic_cast<QObject *>(interceptor))
+            configuration.interceptors.append(interceptor);
+
+    QMutexLocker locker(&threadManagersMutex);
+    sharedConfiguration = configuration;
+}
+
+Request ApiBasePrivate::publishedRequest() const
+{
+    QMutexLocker locker(&publishedRequestMutex);
+    return publishedRequestData;
+}
+
+void ApiBasePrivate::publishRequestData()
+{
+    // Requests only read it, so the snapshot is never changed once published
+    const Request snapshot(internalRequestData->clone());
+
+    QMutexLocker locker(&publishedRequestMutex);
+    publishedRequestData = snapshot;
+}
+
 void ApiBasePrivate::setNetworkManager(NetworkManager *manager)
 {
     m_networkManager = manager;
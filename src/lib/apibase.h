@@ -24,43 +24,54 @@ class RESTLINK_EXPORT ApiBase : public QObject, public RequestInterface
     Q_OBJECT
 
 public:
+    enum NetworkManagerPolicy {
+        SharedNetworkManager,
+        PerThreadNetworkManager
+    };
+    Q_ENUM(NetworkManagerPolicy)
+
     virtual ~ApiBase();
 
     virtual QUrl url() const = 0;
 
     virtual QLocale locale() const;
 
-    void head(const Request &request, const ApiRunCallback &callback);
-    Response *head(const Request &request);
+    void head(Request request, const ApiRunCallback &callback);
+    Response *head(Request request);
 
-    void get(const Request &request, const ApiRunCallback &callback);
-    Response *get(const Request &request);
+    void get(Request request, const ApiRunCallback &callback);
+    Response *get(Request request);
 
-    void post(const Request &request, const Body &body, const ApiRunCallback &callback);
-    Response *post(const Request &request, const Body &body);
+    void post(Request request, Body body, const ApiRunCallback &callback);
+    Response *post(Request request, Body body);
 
-    void put(const Request &request, const Body &body, const ApiRunCallback &callback);
-    Response *put(const Request &request, const Body &body);
+    void put(Request request, Body body, const ApiRunCallback &callback);
+    Response *put(Request request, Body body);
 
-    void patch(const Request &request, const Body &body, const ApiRunCallback &callback);
-    Response *patch(const Request &request, const Body &body);
+    void patch(Request request, Body body, const ApiRunCallback &callback);
+    Response *patch(Request request, Body body);
 
-    void deleteResource(const Request &request, const ApiRunCallback &callback);
-    Response *deleteResource(const Request &request);
+    void deleteResource(Request request, const ApiRunCallback &callback);
+    Response *deleteResource(Request request);
 
-    virtual Response *send(AbstractRequestHandler::Method method, const Request &request, const Body &body);
+    virtual Response *send(AbstractRequestHandler::Method method, Request request, Body body);
 
     virtual QString userAgent() const;
 
     NetworkManager *networkManager() const;
     void setNetworkManager(NetworkManager *manager);
 
+    NetworkManagerPolicy networkManagerPolicy() const;
+    void setNetworkManagerPolicy(NetworkManagerPolicy policy);
+
 protected:
     ApiBase(ApiBasePrivate *d, QObject *parent);
 
     QScopedPointer<ApiBasePrivate> d_ptr;
 
 private:
+    void parametersChanged() override;
+
     const QList<PathParameter> *constPathParameters() const override;
     QList<PathParameter> *mutablePathParameters() override;
     const QList<QueryParameter> *constQueryParameters() const override;
@@ -7,8 +7,17 @@
 
 #include <RestLink/private/request_p.h>
 
+#include <QtCore/qmutex.h>
+#include <QtCore/qpointer.h>
+
+#include <QtNetwork/qnetworkrequest.h>
+
 namespace RestLink {
 
+class AbstractRequestInterceptor;
+class CookieJar;
+class Cache;
+
 class ApiBasePrivate : public RequestPrivate
 {
 public:
@@ -18,10 +27,38 @@ public:
     NetworkManager *networkManager() const;
     void setNetworkManager(NetworkManager *manager);
 
+    NetworkManager *mainNetworkManager() const;
+    NetworkManager *threadNetworkManager() const;
+    void captureSharedConfiguration();
+
+    Request publishedRequest() const;
+    void publishRequestData();
+
     ApiBase *q_ptr;
 
     RequestPrivate *internalRequestData;
 
+    ApiBase::NetworkManagerPolicy networkManagerPolicy;
+
+    // What per-thread network managers start from, captured from the main one
+    struct SharedConfiguration {
+        QPointer<CookieJar> cookieJar;
+        QPointer<Cache> cache;
+        QNetworkRequest::RedirectPolicy redirectPolicy = QNetworkRequest::SameOriginRedirectPolicy;
+        int transferTimeout = 0;
+        QList<AbstractRequestInterceptor *> interceptors;
+    };
+
+    SharedConfiguration sharedConfiguration; // Guarded by threadManagersMutex
+
+    // Parameters and headers as seen from other threads, republished on each change in the api thread
+    mutable QMutex publishedRequestMutex;
+    Request publishedRequestData;
+
+    const quint64 id; // Keys per-thread managers, unlike addresses, ids are never reused
+    mutable QMutex threadManagersMutex;
+    mutable QList<QPointer<NetworkManager>> threadManagers;
+
 private:
     mutable NetworkManager *m_networkManager;
 };
@@ -13,6 +13,7 @@
 #define RESTLINK_MIME_PLAIN_TEXT   "text/plain"
 #define RESTLINK_MIME_OCTET_STREAM "application/octet-stream"
 #define RESTLINK_MIME_JSON         "application/json"
+#define RESTLINK_MIME_NDJSON       "application/x-ndjson"
 
 class QHttpMultiPart;
 class QIODevice;
@@ -0,0 +1,205 @@
+#include "deferredresponse.h"
+#include "deferredresponse_p.h"
+
+#include <QtNetwork/qnetworkrequest.h>
+#include <QtNetwork/qnetworkreply.h>
+
+namespace RestLink {
+
+/*!
+ * \class RestLink::DeferredResponse
+ * \brief A response standing for another one that isn't available yet.
+ *
+ * Interceptors answering a request asynchronously return a DeferredResponse right away, then
+ * give it the actual response with setTarget() once it exists, for example after a token got
+ * refreshed. Everything is forwarded to the target from there, including its finished() signal
+ * and the data it received before being set.
+ *
+ * Until a target is set, the response is running, has no status and no body. Aborting it
+ * finishes it with QNetworkReply::OperationCanceledError, the target given afterwards gets
+ * aborted immediately.
+ *
+ * \sa AbstractRequestInterceptor::respond()
+ */
+
+DeferredResponse::DeferredResponse(AbstractRequestHandler::Method method, QObject *parent)
+    : Response(new DeferredResponsePrivate(this), parent)
+{
+    RESTLINK_D(DeferredResponse);
+    d->method = method;
+    d->emptyDevice.open(QIODevice::ReadOnly);
+    setResponseDevice(&d->emptyDevice);
+}
+
+DeferredResponse::~DeferredResponse()
+{
+}
+
+AbstractRequestHandler::Method DeferredResponse::method() const
+{
+    RESTLINK_D(const DeferredResponse);
+    return d->method;
+}
+
+bool DeferredResponse::isFinished() const
+{
+    RESTLINK_D(const DeferredResponse);
+    if (d->aborted)
+        return true;
+    return (d->target ? d->target->isFinished() : false);
+}
+
+/*!
+ * \brief Returns true if the response got aborted before its target was set.
+ */
+bool DeferredResponse::isAborted() const
+{
+    RESTLINK_D(const DeferredResponse);
+    return d->aborted;
+}
+
+int DeferredResponse::httpStatusCode() const
+{
+    RESTLINK_D(const DeferredResponse);
+    return (d->target ? d->target->httpStatusCode() : 0);
+}
+
+QString DeferredResponse::httpReasonPhrase() const
+{
+    RESTLINK_D(const DeferredResponse);
+    return (d->target ? d->target->httpReasonPhrase() : QString());
+}
+
+bool DeferredResponse::hasHeader(const QString &name) const
+{
+    RESTLINK_D(const DeferredResponse);
+    return (d->target ? d->target->hasHeader(name) : false);
+}
+
+QString DeferredResponse::header(const QString &name) const
+{
+    RESTLINK_D(const DeferredResponse);
+    return (d->target ? d->target->header(name) : QString());
+}
+
+QStringList DeferredResponse::headerList() const
+{
+    RESTLINK_D(const DeferredResponse);
+    return (d->target ? d->target->headerList() : QStringList());
+}
+
+QByteArray DeferredResponse::readBody()
+{
+    RESTLINK_D(DeferredResponse);
+    return (d->target ? d->target->readBody() : QByteArray());
+}
+
+int DeferredResponse::networkError() const
+{
+    RESTLINK_D(const DeferredResponse);
+    if (d->aborted)
+        return QNetworkReply::OperationCanceledError;
+    return (d->target ? d->target->networkError() : QNetworkReply::NoError);
+}
+
+QString DeferredResponse::networkErrorString() const
+{
+    RESTLINK_D(const DeferredResponse);
+    if (d->aborted)
+        return QStringLiteral("Operation canceled");
+    return (d->target ? d->target->networkErrorString() : QString());
+}
+
+QNetworkRequest DeferredResponse::networkRequest() const
+{
+    RESTLINK_D(const DeferredResponse);
+    return (d->target ? d->target->networkRequest() : QNetworkRequest());
+}
+
+QNetworkReply *DeferredResponse::networkReply() const
+{
+    RESTLINK_D(const DeferredResponse);
+    return (d->target ? d->target->networkReply() : nullptr);
+}
+
+/*!
+ * \brief Returns the response this one stands for, nullptr if it's not known yet.
+ */
+Response *DeferredResponse::target() const
+{
+    RESTLINK_D(const DeferredResponse);
+    return d->target;
+}
+
+/*!
+ * \brief Sets the response this one stands for and takes its ownership.
+ *
+ * The target can only be set once. If \a response already received data, readyRead() is
+ * emitted right away, and so is finished() if it is already finished.
+ */
+void DeferredResponse::setTarget(Response *response)
+{
+    RESTLINK_D(DeferredResponse);
+    if (!response || d->target)
+        return;
+
+    d->target = response;
+    response->setParent(this);
+
+    connect(response, &Response::downloadProgress, this, &Response::downloadProgress);
+    connect(response, &Response::uploadProgress, this, &Response::uploadProgress);
+    connect(response, &Response::sslErrorsOccured, this, &Response::sslErrorsOccured);
+    connect(response, &Response::networkErrorOccured, this, &Response::networkErrorOccured);
+    setResponseDevice(response);
+
+    if (d->aborted) {
+        response->abort();
+        return;
+    }
+
+    if (d->sslErrorsIgnored)
+        response->ignoreSslErrors();
+
+    if (response->bytesAvailable() > 0)
+        emit readyRead();
+
+    if (response->isFinished())
+        emit finished();
+    else
+        connect(response, &Response::finished, this, &Response::finished);
+}
+
+void DeferredResponse::ignoreSslErrors()
+{
+    RESTLINK_D(DeferredResponse);
+    d->sslErrorsIgnored = true;
+    if (d->target)
+        d->target->ignoreSslErrors();
+}
+
+void DeferredResponse::abort()
+{
+    RESTLINK_D(DeferredResponse);
+    if (d->target) {
+        d->target->abort();
+        return;
+    }
+
+    if (d->aborted)
+        return;
+
+    d->aborted = true;
+    emit networkErrorOccured(QNetworkReply::OperationCanceledError);
+    emit finished();
+}
+
+DeferredResponsePrivate::DeferredResponsePrivate(Response *q)
+    : ResponsePrivate(q)
+    , method(AbstractRequestHandler::UnknownMethod)
+    , target(nullptr)
+    , sslErrorsIgnored(false)
+    , aborted(false)
+{
+}
+
+} // namespace RestLink
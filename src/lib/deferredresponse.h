@@ -0,0 +1,48 @@
+#ifndef RESTLINK_DEFERREDRESPONSE_H
+#define RESTLINK_DEFERREDRESPONSE_H
+
+#include <RestLink/global.h>
+#include <RestLink/response.h>
+
+namespace RestLink {
+
+class DeferredResponsePrivate;
+class RESTLINK_EXPORT DeferredResponse : public Response
+{
+    Q_OBJECT
+
+public:
+    DeferredResponse(AbstractRequestHandler::Method method, QObject *parent);
+    ~DeferredResponse();
+
+    AbstractRequestHandler::Method method() const override;
+
+    bool isFinished() const override;
+    bool isAborted() const;
+
+    int httpStatusCode() const override;
+    QString httpReasonPhrase() const override;
+
+    bool hasHeader(const QString &name) const override;
+    QString header(const QString &name) const override;
+    QStringList headerList() const override;
+
+    QByteArray readBody() override;
+
+    int networkError() const override;
+    QString networkErrorString() const override;
+
+    QNetworkRequest networkRequest() const override;
+    QNetworkReply *networkReply() const override;
+
+    Response *target() const;
+    void setTarget(Response *response);
+
+public slots:
+    void ignoreSslErrors() override;
+    void abort() override;
+};
+
+} // namespace RestLink
+
+#endif // RESTLINK_DEFERREDRESPONSE_H
@@ -0,0 +1,26 @@
+#ifndef RESTLINK_DEFERREDRESPONSE_P_H
+#define RESTLINK_DEFERREDRESPONSE_P_H
+
+#include "deferredresponse.h"
+
+#include "response_p.h"
+
+#include <QtCore/qbuffer.h>
+
+namespace RestLink {
+
+class DeferredResponsePrivate : public ResponsePrivate
+{
+public:
+    DeferredResponsePrivate(Response *q);
+
+    AbstractRequestHandler::Method method;
+    Response *target;
+    QBuffer emptyDevice; // Read from until the target is known
+    bool sslErrorsIgnored;
+    bool aborted;
+};
+
+} // namespace RestLink
+
+#endif // RESTLINK_DEFERREDRESPONSE_P_H
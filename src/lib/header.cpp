@@ -3,8 +3,35 @@
 
 #include <RestLink/private/parameter_p.h>
 
+#include <QtCore/qmetaobject.h>
+#include <QtCore/qmultihash.h>
+
 namespace RestLink {
 
+namespace {
+
+// Well known header names, interned once by case insensitive name hash
+struct WellKnownHeaders
+{
+    WellKnownHeaders()
+    {
+        const QMetaEnum e = QMetaEnum::fromType<QHttpHeaders::WellKnownHeader>();
+        for (int i(0); i < e.keyCount(); ++i) {
+            const int id = e.value(i);
+            const QString name = QString::fromLatin1(QHttpHeaders::wellKnownHeaderName(QHttpHeaders::WellKnownHeader(id)));
+            ids.insert(Parameter::hashName(name), id);
+            names.insert(id, name);
+        }
+    }
+
+    QMultiHash<uint, int> ids;
+    QHash<int, QString> names;
+};
+
+Q_GLOBAL_STATIC(WellKnownHeaders, wellKnownHeaders)
+
+}
+
 Header::Header()
     : Parameter(new HeaderData())
 {
@@ -17,6 +44,19 @@ Header::Header(const QString &name, const QVariant &value)
     setValue(value);
 }
 
+Header::Header(QHttpHeaders::WellKnownHeader name, const QVariant &value)
+    : Parameter(new HeaderData())
+{
+    // Canonical casing, "content-type" becomes "Content-Type"
+    QString canonicalName = wellKnownHeaders->names.value(int(name));
+    for (qsizetype i(0); i < canonicalName.size(); ++i)
+        if (i == 0 || canonicalName.at(i - 1) == '-')
+            canonicalName[i] = canonicalName.at(i).toUpper();
+
+    setName(canonicalName);
+    setValue(value);
+}
+
 Header::Header(const Header &other)
     : Parameter(other)
 {
@@ -38,6 +78,26 @@ Header &Header::operator=(const Header &other)
     return *this;
 }
 
+int Header::id() const
+{
+    return d_ptr->nameId;
+}
+
+bool Header::isWellKnown() const
+{
+    return d_ptr->nameId >= 0;
+}
+
+QHttpHeaders::WellKnownHeader Header::wellKnownName() const
+{
+    return QHttpHeaders::WellKnownHeader(d_ptr->nameId);
+}
+
+int Header::idOf(QStringView name)
+{
+    return HeaderData::wellKnownId(name, hashName(name));
+}
+
 Header Header::fromJsonObject(const QJsonObject &object)
 {
     Header h;
@@ -45,4 +105,13 @@ Header Header::fromJsonObject(const QJsonObject &object)
     return h;
 }
 
+int HeaderData::wellKnownId(QStringView name, uint hash)
+{
+    const WellKnownHeaders *headers = wellKnownHeaders();
+    for (auto it = headers->ids.constFind(hash); it != headers->ids.cend() && it.key() == hash; ++it)
+        if (name.compare(headers->names.value(it.value()), Qt::CaseInsensitive) == 0)
+            return it.value();
+    return -1;
+}
+
 }
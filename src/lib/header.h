@@ -5,6 +5,8 @@
 #include <RestLink/parameter.h>
 #include <RestLink/parameterlist.h>
 
+#include <QtNetwork/qhttpheaders.h>
+
 namespace RestLink {
 
 class HeaderData;
@@ -13,11 +15,18 @@ class RESTLINK_EXPORT Header : public Parameter
 public:
     Header();
     Header(const QString &name, const QVariant &value);
+    Header(QHttpHeaders::WellKnownHeader name, const QVariant &value);
     Header(const Header &other);
     Header(Header &&other);
 
     Header &operator=(const Header &other);
 
+    int id() const;
+    bool isWellKnown() const;
+    QHttpHeaders::WellKnownHeader wellKnownName() const;
+
+    static int idOf(QStringView name);
+
     static Header fromJsonObject(const QJsonObject &object);
 
 protected:
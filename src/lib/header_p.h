@@ -10,6 +10,8 @@ class HeaderData : public ParameterData
 public:
     Parameter::Type type() const override
     { return Parameter::HeaderType; }
+
+    static int wellKnownId(QStringView name, uint hash);
 };
 
 }
@@ -16,6 +16,8 @@ namespace RestLink {
  * This class extends QAbstractNetworkCache to provide custom caching
  * functionality for the RestLink API. It interacts with CachePrivate to
  * manage cache storage and retrieval.
+ *
+ * Cache accesses are serialized, so that network managers of several threads can share it.
  */
 
 Cache::Cache(QObject *parent) :
@@ -40,6 +42,7 @@ Cache::~Cache()
  */
 qint64 Cache::maxCacheSize() const
 {
+    QMutexLocker locker(&d->mutex);
     return d->maximumCacheSize();
 }
 
@@ -53,8 +56,10 @@ qint64 Cache::maxCacheSize() const
  */
 void Cache::setMaxCacheSize(qint64 size)
 {
+    QMutexLocker locker(&d->mutex);
     if (d->maximumCacheSize() != size) {
         d->setMaximumCacheSize(size);
+        locker.unlock();
         emit maxCacheSizeChanged(size);
     }
 }
@@ -70,6 +75,7 @@ void Cache::setMaxCacheSize(qint64 size)
  */
 QNetworkCacheMetaData Cache::metaData(const QUrl &url)
 {
+    QMutexLocker locker(&d->mutex);
     return d->metaData(d->cacheUrl(url));
 }
 
@@ -80,6 +86,7 @@ QNetworkCacheMetaData Cache::metaData(const QUrl &url)
  */
 void Cache::updateMetaData(const QNetworkCacheMetaData &metaData)
 {
+    QMutexLocker locker(&d->mutex);
     d->updateMetaData(d->cacheMetaData(metaData));
 }
 
@@ -95,6 +102,7 @@ void Cache::updateMetaData(const QNetworkCacheMetaData &metaData)
  */
 QIODevice *Cache::data(const QUrl &url)
 {
+    QMutexLocker locker(&d->mutex);
     return d->data(d->cacheUrl(url));
 }
 
@@ -107,6 +115,7 @@ QIODevice *Cache::data(const QUrl &url)
  */
 bool Cache::remove(const QUrl &url)
 {
+    QMutexLocker locker(&d->mutex);
     return d->remove(d->cacheUrl(url));
 }
 
@@ -117,6 +126,7 @@ bool Cache::remove(const QUrl &url)
  */
 qint64 Cache::cacheSize() const
 {
+    QMutexLocker locker(&d->mutex);
     return d->cacheSize();
 }
 
@@ -132,6 +142,7 @@ qint64 Cache::cacheSize() const
  */
 QIODevice *Cache::prepare(const QNetworkCacheMetaData &metaData)
 {
+    QMutexLocker locker(&d->mutex);
     return d->prepare(d->cacheMetaData(metaData));
 }
 
@@ -144,6 +155,7 @@ QIODevice *Cache::prepare(const QNetworkCacheMetaData &metaData)
  */
 void Cache::insert(QIODevice *device)
 {
+    QMutexLocker locker(&d->mutex);
     d->insert(device);
 }
 
@@ -154,6 +166,7 @@ void Cache::insert(QIODevice *device)
  */
 void Cache::clear()
 {
+    QMutexLocker locker(&d->mutex);
     d->clear();
 }
 
@@ -199,4 +212,53 @@ QIODevice *CachePrivate::prepare(const QNetworkCacheMetaData &metaData)
     return QNetworkDiskCache::prepare(metaData);
 }
 
+CacheProxy::CacheProxy(Cache *cache, QObject *parent) :
+    QAbstractNetworkCache(parent),
+    m_cache(cache)
+{
+}
+
+QNetworkCacheMetaData CacheProxy::metaData(const QUrl &url)
+{
+    return (m_cache ? m_cache->metaData(url) : QNetworkCacheMetaData());
+}
+
+void CacheProxy::updateMetaData(const QNetworkCacheMetaData &metaData)
+{
+    if (m_cache)
+        m_cache->updateMetaData(metaData);
+}
+
+QIODevice *CacheProxy::data(const QUrl &url)
+{
+    return (m_cache ? m_cache->data(url) : nullptr);
+}
+
+bool CacheProxy::remove(const QUrl &url)
+{
+    return (m_cache ? m_cache->remove(url) : false);
+}
+
+qint64 CacheProxy::cacheSize() const
+{
+    return (m_cache ? m_cache->cacheSize() : 0);
+}
+
+QIODevice *CacheProxy::prepare(const QNetworkCacheMetaData &metaData)
+{
+    return (m_cache ? m_cache->prepare(metaData) : nullptr);
+}
+
+void CacheProxy::insert(QIODevice *device)
+{
+    if (m_cache)
+        m_cache->insert(device);
+}
+
+void CacheProxy::clear()
+{
+    if (m_cache)
+        m_cache->clear();
+}
+
 } // namespace RestLink
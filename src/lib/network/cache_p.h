@@ -3,6 +3,9 @@
 
 #include "cache.h"
 
+#include <QtCore/qmutex.h>
+#include <QtCore/qpointer.h>
+
 #include <QtNetwork/qnetworkdiskcache.h>
 
 namespace RestLink {
@@ -20,6 +23,30 @@ public:
     QIODevice *prepare(const QNetworkCacheMetaData &metaData) override;
 
     Cache *q;
+
+    // Network managers of several threads may share the cache
+    QMutex mutex;
+};
+
+// Lets a network manager of another thread use a cache without owning it
+class CacheProxy : public QAbstractNetworkCache
+{
+    Q_OBJECT
+
+public:
+    CacheProxy(Cache *cache, QObject *parent = nullptr);
+
+    QNetworkCacheMetaData metaData(const QUrl &url) override;
+    void updateMetaData(const QNetworkCacheMetaData &metaData) override;
+    QIODevice *data(const QUrl &url) override;
+    bool remove(const QUrl &url) override;
+    qint64 cacheSize() const override;
+    QIODevice *prepare(const QNetworkCacheMetaData &metaData) override;
+    void insert(QIODevice *device) override;
+    void clear() override;
+
+private:
+    const QPointer<Cache> m_cache;
 };
 
 }
@@ -90,16 +90,55 @@ bool CookieJar::saveToDevice(QIODevice *device) const
 void CookieJar::loadFromData(const QByteArray &data)
 {
     const QList<QNetworkCookie> cookies = QNetworkCookie::parseCookies(data);
+    QMutexLocker locker(&d_ptr->mutex);
     setAllCookies(cookies);
 }
 
 void CookieJar::saveToData(QByteArray *data) const
 {
+    QMutexLocker locker(&d_ptr->mutex);
     const QList<QNetworkCookie> cookies = allCookies();
+    locker.unlock();
+
     for (const QNetworkCookie &cookie : cookies)
         data->append(cookie.toRawForm(QNetworkCookie::Full) + '\n');
 }
 
+/**
+ * @brief Returns the cookies to send to \a url.
+ *
+ * The jar can be shared by network managers of several threads, all cookie accesses are serialized.
+ */
+QList<QNetworkCookie> CookieJar::cookiesForUrl(const QUrl &url) const
+{
+    QMutexLocker locker(&d_ptr->mutex);
+    return QNetworkCookieJar::cookiesForUrl(url);
+}
+
+bool CookieJar::setCookiesFromUrl(const QList<QNetworkCookie> &cookieList, const QUrl &url)
+{
+    QMutexLocker locker(&d_ptr->mutex);
+    return QNetworkCookieJar::setCookiesFromUrl(cookieList, url);
+}
+
+bool CookieJar::insertCookie(const QNetworkCookie &cookie)
+{
+    QMutexLocker locker(&d_ptr->mutex);
+    return QNetworkCookieJar::insertCookie(cookie);
+}
+
+bool CookieJar::updateCookie(const QNetworkCookie &cookie)
+{
+    QMutexLocker locker(&d_ptr->mutex);
+    return QNetworkCookieJar::updateCookie(cookie);
+}
+
+bool CookieJar::deleteCookie(const QNetworkCookie &cookie)
+{
+    QMutexLocker locker(&d_ptr->mutex);
+    return QNetworkCookieJar::deleteCookie(cookie);
+}
+
 CookieJarPrivate::CookieJarPrivate(CookieJar *q)
     : fileName(FileUtils::generateCookieFile())
 {
@@ -28,6 +28,12 @@ public:
     void loadFromData(const QByteArray &data);
     void saveToData(QByteArray *data) const;
 
+    QList<QNetworkCookie> cookiesForUrl(const QUrl &url) const override;
+    bool setCookiesFromUrl(const QList<QNetworkCookie> &cookieList, const QUrl &url) override;
+    bool insertCookie(const QNetworkCookie &cookie) override;
+    bool updateCookie(const QNetworkCookie &cookie) override;
+    bool deleteCookie(const QNetworkCookie &cookie) override;
+
 private:
     QScopedPointer<CookieJarPrivate> d_ptr;
 };
@@ -3,6 +3,8 @@
 
 #include "cookiejar.h"
 
+#include <QtCore/qmutex.h>
+
 namespace RestLink {
 
 class CookieJarPrivate
@@ -13,6 +15,9 @@ public:
     static QString generateCookieFile();
 
     QString fileName;
+
+    // Network managers of several threads may share the jar
+    mutable QRecursiveMutex mutex;
 };
 
 }
@@ -1,4 +1,5 @@
 #include "networkmanager.h"
+#include "networkmanager_p.h"
 
 #include <RestLink/debug.h>
 #include <RestLink/request.h>
@@ -40,24 +41,17 @@ namespace RestLink {
  */
 NetworkManager::NetworkManager(QObject *parent)
     : QNetworkAccessManager{parent}
+    , AbstractRequestHandler(new NetworkManagerPrivate(this))
 {
     setRedirectPolicy(QNetworkRequest::SameOriginRedirectPolicy);
 }
 
 Response *NetworkManager::sendRequest(Method method, const Request &request, const Body &body)
 {
-    const QString requestScheme = request.baseUrl().scheme();
-#ifdef Q_OS_WASM
-    // Workaround for a Qt bug on WebAssembly, http and https didn't appears in supported schemes
-    const QStringList httpSchemes = { "http", "https" }; // force HTTP/HTTPS support on WASM
-#else
-    // Here we don't enforce https cause it depends on SSL support and works well on non WASM platform
-    const QStringList httpSchemes = { "http" }; // force HTTP support on all platforms
-#endif
+    AbstractRequestHandler *handler = route(request.baseUrl().scheme());
 
     // If it's supported, send though QNetworkAccessManager base
-    const QStringList networkSchemes = QNetworkAccessManager::supportedSchemes();
-    if (httpSchemes.contains(requestScheme) || networkSchemes.contains(requestScheme)) {
+    if (handler == this) {
         QNetworkRequest netRequest = generateNetworkRequest(method, request, body);
         QNetworkReply *netReply = generateNetworkReply(method, netRequest, body);
 
@@ -68,15 +62,7 @@ Response *NetworkManager::sendRequest(Method method, const Request &request, con
     }
 
     // Otherwise, try using plugin handlers
-    QList<AbstractRequestHandler *> handlers = PluginManager::handlers();
-
-    auto it = std::find_if(handlers.begin(), handlers.end(), [&requestScheme](const AbstractRequestHandler *handler) {
-        return handler->supportedSchemes().contains(requestScheme);
-    });
-
-    if (it != handlers.end()) {
-        AbstractRequestHandler *handler = *it;
-
+    if (handler) {
         Response *response = handler->send(method, request, body);
         if (!response)
             restlinkWarning() << handler->handlerName() << ": response object creation failed, probably plugin related error";
@@ -90,20 +76,36 @@ Response *NetworkManager::sendRequest(Method method, const Request &request, con
 
 QStringList NetworkManager::supportedSchemes() const
 {
-    // Getting schemes from QNetworkAccessManager and network handlers
-    QStringList schemes = QNetworkAccessManager::supportedSchemes();
-    const QList<AbstractRequestHandler *> handlers = PluginManager::handlers();
-    for (AbstractRequestHandler *handler : handlers)
-        schemes.append(handler->supportedSchemes());
+    // QObject has a d_ptr too, the handler one has to be named
+    const NetworkManagerPrivate *d = static_cast<const NetworkManagerPrivate *>(AbstractRequestHandler::d_ptr.get());
+    d->updateRoutes();
+    return d->schemes;
+}
 
-#ifdef Q_OS_WASM
-    // Force HTTP/HTTPS on WASM
-    schemes.append({ "https", "http" });
-#endif
+bool NetworkManager::isSchemeSupported(const QString &scheme) const
+{
+    return route(scheme) != nullptr;
+}
 
-    // Removing duplicates and returning schemes
-    schemes.removeDuplicates();
-    return schemes;
+/**
+ * @brief Returns the handler requests using \a scheme are dispatched to.
+ *
+ * The network manager itself is returned for schemes supported by QNetworkAccessManager,
+ * a plugin handler for other schemes it supports, nullptr for unsupported schemes.
+ * Lookups use a table built on first use and rebuilt when plugins change, plugin handlers
+ * only get created when one of their schemes is routed.
+ */
+AbstractRequestHandler *NetworkManager::route(const QString &scheme) const
+{
+    const NetworkManagerPrivate *d = static_cast<const NetworkManagerPrivate *>(AbstractRequestHandler::d_ptr.get());
+    d->updateRoutes();
+
+    auto it = d->routes.constFind(scheme);
+    if (it == d->routes.constEnd())
+        return nullptr;
+
+    // Plugin scheme, the handler gets created on first use
+    return (*it ? *it : PluginManager::handler(scheme));
 }
 
 AbstractRequestHandler::HandlerType NetworkManager::handlerType() const
@@ -119,13 +121,24 @@ QNetworkRequest NetworkManager::generateNetworkRequest(Method method, const Requ
     // Api, Request and Body headers
     const HeaderList allHeaders = (request.api() ? request.api()->headers() : HeaderList()) + request.headers() + body.headers();
     for (const Header &header : allHeaders) {
+        // Well known headers don't need their names to be converted and compared as strings
+        if (header.isWellKnown()) {
+            const QHttpHeaders::WellKnownHeader name = header.wellKnownName();
+            if (httpHeaders.contains(name))
+                httpHeaders.removeAll(name);
+
+            for (qsizetype i(0); i < header.valueCount(); ++i)
+                httpHeaders.append(name, header.text(i));
+            continue;
+        }
+
         const QString name = header.name();
         if (httpHeaders.contains(name))
             httpHeaders.removeAll(name);
 
-        const QVariantList values = header.values();
-        for (const QVariant &value : values)
-            httpHeaders.append(name, value.toString());
+        // Values were serialized when set
+        for (qsizetype i(0); i < header.valueCount(); ++i)
+            httpHeaders.append(name, header.text(i));
     }
 
     // Compression support
@@ -234,4 +247,48 @@ QNetworkReply *NetworkManager::generateNetworkReply(Method method, const QNetwor
     return reply;
 }
 
+NetworkManagerPrivate::NetworkManagerPrivate(NetworkManager *q)
+    : q_ptr(q)
+    , routesRevision(0)
+    , routesValid(false)
+{
+}
+
+void NetworkManagerPrivate::updateRoutes() const
+{
+    if (routesValid && routesRevision == PluginManager::revision())
+        return;
+
+    routes.clear();
+    schemes.clear();
+
+    auto addRoute = [this](const QString &scheme, AbstractRequestHandler *handler) {
+        if (routes.contains(scheme))
+            return;
+        routes.insert(scheme, handler);
+        schemes.append(scheme);
+    };
+
+    // Schemes supported by QNetworkAccessManager first, plugins can't take them over
+    const QStringList networkSchemes = q_ptr->QNetworkAccessManager::supportedSchemes();
+    for (const QString &scheme : networkSchemes)
+        addRoute(scheme, q_ptr);
+
+#ifdef Q_OS_WASM
+    // Workaround for a Qt bug on WebAssembly, http and https didn't appears in supported schemes
+    addRoute("https", q_ptr);
+#endif
+    // Here we don't enforce https cause it depends on SSL support and works well on non WASM platform
+    addRoute("http", q_ptr);
+
+    // Plugin handlers are only created when a request needs them
+    const QStringList pluginSchemes = PluginManager::schemes();
+    for (const QString &scheme : pluginSchemes)
+        addRoute(scheme, nullptr);
+
+    // Loading plugins may have changed the revision
+    routesRevision = PluginManager::revision();
+    routesValid = true;
+}
+
 }
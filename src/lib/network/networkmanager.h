@@ -27,6 +27,9 @@ public:
     HandlerType handlerType() const override final;
 
 protected:
+    bool isSchemeSupported(const QString &scheme) const override final;
+    AbstractRequestHandler *route(const QString &scheme) const;
+
     Response *sendRequest(Method method, const Request &request, const Body &body) override;
 
     QNetworkRequest generateNetworkRequest(Method method, const Request &request, const Body &body);
@@ -0,0 +1,30 @@
+#ifndef RESTLINK_NETWORKMANAGER_P_H
+#define RESTLINK_NETWORKMANAGER_P_H
+
+#include "networkmanager.h"
+
+#include <RestLink/private/abstractrequesthandler_p.h>
+
+#include <QtCore/qhash.h>
+
+namespace RestLink {
+
+class NetworkManagerPrivate : public AbstractRequestHandlerPrivate
+{
+public:
+    NetworkManagerPrivate(NetworkManager *q);
+
+    void updateRoutes() const;
+
+    NetworkManager *q_ptr;
+
+    // Handler by scheme, nullptr for plugin handlers not created yet
+    mutable QHash<QString, AbstractRequestHandler *> routes;
+    mutable QStringList schemes;
+    mutable quint64 routesRevision;
+    mutable bool routesValid;
+};
+
+} // namespace RestLink
+
+#endif // RESTLINK_NETWORKMANAGER_P_H
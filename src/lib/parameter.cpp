@@ -149,13 +149,27 @@ QString Parameter::name() const
     return d_ptr->name;
 }
 
+/*!
+ * \brief Retrieves the case-insensitive hash of the parameter name.
+ *
+ * The hash is computed once, when the name is set, so that lookups by name only compare
+ * integers until a candidate is found.
+ *
+ * \return The hash of the parameter name.
+ * \sa hashName()
+ */
+uint Parameter::nameHash() const
+{
+    return d_ptr->nameHash;
+}
+
 /*!
  * \brief Sets the name of the parameter.
  * \param name The name to set for the parameter.
  */
 void Parameter::setName(const QString &name)
 {
-    d_ptr->name = d_ptr->validateName(name);
+    d_ptr->setName(name);
 }
 
 /*!
@@ -167,6 +181,47 @@ QVariant Parameter::value() const
     return (!d_ptr->values.isEmpty() ? d_ptr->values.constFirst() : QVariant());
 }
 
+/*!
+ * \brief Returns the number of values held by the parameter.
+ */
+qsizetype Parameter::valueCount() const
+{
+    return d_ptr->values.size();
+}
+
+/*!
+ * \brief Returns the value at \a index in its serialized form.
+ *
+ * Values are converted to strings once, when they are set, so building urls and headers
+ * from parameters doesn't go through QVariant conversions.
+ *
+ * \param index The index of the value, the first one by default.
+ * \return The serialized value, or a null string if there is no such value.
+ */
+QString Parameter::text(qsizetype index) const
+{
+    if (index == 0)
+        return d_ptr->firstText;
+    return d_ptr->otherTexts.value(index - 1);
+}
+
+/*!
+ * \brief Returns the special value at \a index in its serialized form.
+ *
+ * This is the serialized counterpart of specialValues(), without building a list.
+ *
+ * \param api The API used to determine the special value.
+ * \param index The index of the value, the first one by default.
+ * \return The serialized special value.
+ * \sa text(), specialValue()
+ */
+QString Parameter::specialText(Api *api, qsizetype index) const
+{
+    if (api && hasFlag(Locale) && index < d_ptr->values.size())
+        return d_ptr->localeText(api);
+    return text(index);
+}
+
 /*!
  * \brief Sets the value of the parameter.
  * \param value The value to set for the parameter.
@@ -175,9 +230,9 @@ void Parameter::setValue(const QVariant &value)
 {
     const QVariant finalValue = d_ptr->validateValue(value);
     if (finalValue.isValid())
-        d_ptr->values = { finalValue };
+        d_ptr->setValues({ finalValue });
     else
-        d_ptr->values.clear();
+        d_ptr->setValues(QVariantList());
 }
 
 /*!
@@ -190,9 +245,13 @@ void Parameter::setValue(const QVariant &value)
  */
 QVariant Parameter::specialValue(Api *api) const
 {
-    // ToDo: Optimize for better performances
-    const QVariantList values = specialValues(api);
-    return !values.isEmpty() ? values.first() : QVariant();
+    if (d_ptr->values.isEmpty())
+        return QVariant();
+
+    if (api && hasFlag(Locale))
+        return d_ptr->localeText(api);
+
+    return d_ptr->values.constFirst();
 }
 
 /*!
@@ -205,26 +264,12 @@ QVariant Parameter::specialValue(Api *api) const
  */
 QVariantList Parameter::specialValues(Api *api) const
 {
-    QVariantList values;
+    if (!api || !hasFlag(Locale))
+        return d_ptr->values;
 
-    const QVariant mainValue = this->value();
-    std::transform(d_ptr->values.begin(), d_ptr->values.end(), std::back_inserter(values), [this, api, &mainValue](const QVariant &value) {
-        if (hasFlag(Locale)) {
-            const QLocale locale = api->locale();
-            const QString format = mainValue.toString();
-
-            if (format == ".")
-                return QVariant(locale.name().section("_", 0, 0));
-            else if (format == "-")
-                return QVariant(locale.name(QLocale::TagSeparator::Dash));
-            else
-                return QVariant(locale.name(QLocale::TagSeparator::Underscore));
-        }
-
-        return value;
-    });
-
-    return values;
+    // Every value of a locale parameter stands for the Api locale
+    const QVariant locale = d_ptr->localeText(api);
+    return QVariantList(d_ptr->values.size(), locale);
 }
 
 /*!
@@ -247,7 +292,7 @@ void Parameter::addValue(const QVariant &value)
 {
     const QVariant finalValue = d_ptr->validateValue(value);
     if (finalValue.isValid())
-        d_ptr->values.append(finalValue);
+        d_ptr->appendValue(finalValue);
 }
 
 /*!
@@ -257,7 +302,8 @@ void Parameter::addValue(const QVariant &value)
  */
 void Parameter::removeValue(const QVariant &value)
 {
-    d_ptr->values.removeOne(value);
+    if (d_ptr->values.removeOne(value))
+        d_ptr->serializeValues();
 }
 
 /*!
@@ -277,7 +323,7 @@ QVariantList Parameter::values() const
  */
 void Parameter::setValues(const QVariantList &values)
 {
-    d_ptr->values = d_ptr->validateValues(values);
+    d_ptr->setValues(d_ptr->validateValues(values));
 }
 
 /*!
@@ -428,6 +474,26 @@ Parameter Parameter::merge(const Parameter &r1, const Parameter &r2)
     return r1;
 }
 
+/*!
+ * \brief Computes a case-insensitive hash of a parameter name.
+ *
+ * Names that only differ by case share the same hash, which makes it usable to look up
+ * headers as well as case sensitive parameters, provided names get compared on a match.
+ *
+ * \param name The name to hash.
+ * \return The hash of the name.
+ */
+uint Parameter::hashName(QStringView name)
+{
+    // FNV-1a over case folded UTF-16 code units
+    uint hash = 2166136261u;
+    for (const QChar c : name) {
+        hash ^= c.toCaseFolded().unicode();
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 /*!
  * \brief Equality operator for Parameter class.
  *
@@ -457,10 +523,52 @@ bool Parameter::operator!=(const Parameter &other) const
     return !operator==(other);
 }
 
+void ParameterData::setName(const QString &name)
+{
+    this->name = validateName(name);
+    nameHash = Parameter::hashName(this->name);
+    nameId = HeaderData::wellKnownId(this->name, nameHash);
+}
+
+void ParameterData::setValues(const QVariantList &values)
+{
+    this->values = values;
+    serializeValues();
+}
+
+void ParameterData::appendValue(const QVariant &value)
+{
+    values.append(value);
+    if (values.size() == 1)
+        firstText = value.toString();
+    else
+        otherTexts.append(value.toString());
+}
+
+void ParameterData::serializeValues()
+{
+    firstText = (!values.isEmpty() ? values.constFirst().toString() : QString());
+    otherTexts.clear();
+    for (qsizetype i(1); i < values.size(); ++i)
+        otherTexts.append(values.at(i).toString());
+}
+
+QString ParameterData::localeText(Api *api) const
+{
+    // The first value tells the locale format
+    const QLocale locale = api->locale();
+    if (firstText == ".")
+        return locale.name().section("_", 0, 0);
+    else if (firstText == "-")
+        return locale.name(QLocale::TagSeparator::Dash);
+    else
+        return locale.name(QLocale::TagSeparator::Underscore);
+}
+
 void Parameter::dataFromJsonObject(ParameterData *data, const QJsonObject &object)
 {
-    data->name = data->validateName(object.value("name").toString());
-    data->values = data->validateValues({object.value("value").toVariant()});
+    data->setName(object.value("name").toString());
+    data->setValues(data->validateValues({object.value("value").toVariant()}));
 
     auto setFlag = [object, data](const QString &name, Flag flag, bool defaultValue) {
         bool value = (object.contains(name) ? object.value(name).toBool() : defaultValue);
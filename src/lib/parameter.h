@@ -5,6 +5,7 @@
 
 #include <QtCore/qshareddata.h>
 #include <QtCore/qlist.h>
+#include <QtCore/qstringview.h>
 
 class QJsonObject;
 
@@ -45,13 +46,18 @@ public:
     Parameter &operator=(Parameter &&other);
 
     QString name() const;
+    uint nameHash() const;
     void setName(const QString &name);
 
     QVariant value() const;
     void setValue(const QVariant &value);
 
+    qsizetype valueCount() const;
+    QString text(qsizetype index = 0) const;
+
     QVariant specialValue(Api *api) const;
     QVariantList specialValues(Api *api) const;
+    QString specialText(Api *api, qsizetype index = 0) const;
 
     bool hasValue(const QVariant &value) const;
     void addValue(const QVariant &value);
@@ -80,6 +86,7 @@ public:
     static Parameter fromJsonObject(const QJsonObject &object, Type type);
 
     static Parameter merge(const Parameter &p1, const Parameter &p2);
+    static uint hashName(QStringView name);
 
     bool operator==(const Parameter &other) const;
     bool operator!=(const Parameter &other) const;
@@ -5,14 +5,27 @@
 
 #include <QtCore/qshareddata.h>
 #include <QtCore/qvariant.h>
+#include <QtCore/qstringlist.h>
 
 namespace RestLink {
 
 class ParameterData : public QSharedData
 {
 public:
+    void setName(const QString &name);
+
+    void setValues(const QVariantList &values);
+    void appendValue(const QVariant &value);
+    void serializeValues();
+
+    QString localeText(Api *api) const;
+
     QString name;
+    uint nameHash = Parameter::hashName(QStringView());
+    int nameId = -1; // Interned well known header, if any
     QVariantList values;
+    QString firstText; // Values serialized when set, most parameters only hold one
+    QStringList otherTexts;
     Parameter::Flags flags;
 
     virtual QString validateName(const QString &name) const
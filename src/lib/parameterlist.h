@@ -178,8 +178,10 @@ P ParameterList<P>::newParameter(const QString &name, const QVariantList &values
 template<typename P>
 typename QList<P>::Iterator ParameterList<P>::find(const QString &name, bool *found)
 {
-    auto it = std::find_if(this->begin(), this->end(), [&name](const Parameter &param) {
-        return param.name().compare(name, Qt::CaseInsensitive) == 0;
+    // Names are only compared when their hashes match
+    const uint hash = Parameter::hashName(name);
+    auto it = std::find_if(this->begin(), this->end(), [&name, hash](const Parameter &param) {
+        return param.nameHash() == hash && param.name().compare(name, Qt::CaseInsensitive) == 0;
     });
 
     *found = (it != this->end() ? true : false);
@@ -189,8 +191,9 @@ typename QList<P>::Iterator ParameterList<P>::find(const QString &name, bool *fo
 template<typename P>
 typename QList<P>::ConstIterator ParameterList<P>::find(const QString &name, bool *found) const
 {
-    auto it = std::find_if(this->begin(), this->end(), [&name](const Parameter &param) {
-        return param.name().compare(name, Qt::CaseInsensitive) == 0;
+    const uint hash = Parameter::hashName(name);
+    auto it = std::find_if(this->begin(), this->end(), [&name, hash](const Parameter &param) {
+        return param.nameHash() == hash && param.name().compare(name, Qt::CaseInsensitive) == 0;
     });
 
     *found = (it != this->end() ? true : false);
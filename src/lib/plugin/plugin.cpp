@@ -26,6 +26,12 @@ namespace RestLink {
  * can be attached using setMetaData().
  *
  * When creating a plugin, consider the **RESTLINK_PLUGIN_IID** macro for the IID.
+ *
+ * Plugins should list the schemes they may handle in a "schemes" metadata array, this lets
+ * PluginManager route requests to them without loading them until they are needed.
+ *
+ * createHandler() may be called from any thread, handlers must be returned without a parent,
+ * PluginManager moves them to the application thread and parents them to the application.
  */
 
 /**
@@ -0,0 +1,170 @@
+#include "pluginindex_p.h"
+
+#include <RestLink/debug.h>
+#include <RestLink/plugin.h>
+
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qdiriterator.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qlibrary.h>
+#include <QtCore/qpluginloader.h>
+#include <QtCore/qsavefile.h>
+#include <QtCore/qstandardpaths.h>
+
+namespace RestLink {
+
+// Maps plugin files to their metadata, so that finding plugins and their schemes doesn't require
+// loading them. Entries are kept on disk and reused while the file time and size don't change.
+PluginIndex::PluginIndex()
+    : m_loaded(false)
+    , m_dirty(false)
+{
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!dir.isEmpty())
+        m_fileName = dir + QStringLiteral("/restlink/plugins.json");
+}
+
+QList<PluginIndex::Entry> PluginIndex::scan(const QStringList &names, bool discovery)
+{
+    if (!m_loaded) {
+        load();
+        m_loaded = true;
+    }
+
+    QList<Entry> entries;
+
+    auto processDir = [this, &names, discovery, &entries](const QFileInfo &entry) {
+        const QDir dir(entry.absoluteFilePath());
+        const QFileInfoList files = dir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
+        for (const QFileInfo &file : files) {
+            if (!QLibrary::isLibrary(file.fileName()))
+                continue;
+
+            if (!discovery && !names.contains(file.baseName()))
+                continue;
+
+            const Entry plugin = this->entry(file);
+            if (plugin.isPlugin())
+                entries.append(plugin);
+        }
+    };
+
+    const QStringList searchPaths = QCoreApplication::libraryPaths();
+    for (const QString &path : searchPaths) {
+        QDirIterator it(path, { "restlink" }, QDir::Dirs, QDirIterator::Subdirectories);
+        while (it.hasNext())
+            processDir(it.nextFileInfo());
+    }
+
+    save();
+    return entries;
+}
+
+bool PluginIndex::load()
+{
+    if (m_fileName.isEmpty())
+        return false;
+
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const QJsonObject object = QJsonDocument::fromJson(file.readAll()).object();
+    for (auto it = object.begin(); it != object.end(); ++it) {
+        const QJsonObject entryObject = it.value().toObject();
+
+        Entry entry;
+        entry.fileName = it.key();
+        entry.modified = entryObject.value("modified").toInteger();
+        entry.size = entryObject.value("size").toInteger();
+        entry.iid = entryObject.value("IID").toString();
+        entry.metaData = entryObject.value("MetaData").toObject();
+        m_entries.insert(entry.fileName, entry);
+    }
+
+    m_dirty = false;
+    return !m_entries.isEmpty();
+}
+
+bool PluginIndex::save()
+{
+    if (m_fileName.isEmpty() || !m_dirty)
+        return !m_fileName.isEmpty();
+
+    QJsonObject object;
+    for (const Entry &entry : std::as_const(m_entries)) {
+        QJsonObject entryObject;
+        entryObject.insert("modified", entry.modified);
+        entryObject.insert("size", entry.size);
+        entryObject.insert("IID", entry.iid);
+        if (!entry.metaData.isEmpty())
+            entryObject.insert("MetaData", entry.metaData);
+        object.insert(entry.fileName, entryObject);
+    }
+
+    QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        restlinkWarning() << "Can't write plugin index " << m_fileName;
+        return false;
+    }
+
+    file.write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+    if (!file.commit())
+        return false;
+
+    m_dirty = false;
+    return true;
+}
+
+PluginIndex::Entry PluginIndex::entry(const QFileInfo &file)
+{
+    const QString fileName = file.absoluteFilePath();
+    const qint64 modified = file.lastModified().toMSecsSinceEpoch();
+    const qint64 size = file.size();
+
+    auto it = m_entries.constFind(fileName);
+    if (it != m_entries.constEnd() && it->modified == modified && it->size == size)
+        return *it;
+
+    // Reading metadata doesn't load the library
+    const QJsonObject metaData = QPluginLoader(fileName).metaData();
+
+    Entry entry;
+    entry.fileName = fileName;
+    entry.modified = modified;
+    entry.size = size;
+    entry.iid = metaData.value("IID").toString();
+    entry.metaData = metaData.value("MetaData").toObject();
+
+    m_entries.insert(fileName, entry);
+    m_dirty = true;
+    return entry;
+}
+
+bool PluginIndex::Entry::isPlugin() const
+{
+    return iid == QStringLiteral(RESTLINK_PLUGIN_IID);
+}
+
+QString PluginIndex::Entry::name() const
+{
+    return metaData.value("name").toString();
+}
+
+QStringList PluginIndex::Entry::schemes() const
+{
+    QStringList schemes;
+    const QJsonArray array = metaData.value("schemes").toArray();
+    for (const QJsonValue &value : array)
+        schemes.append(value.toString());
+    return schemes;
+}
+
+} // namespace RestLink
@@ -0,0 +1,46 @@
+#ifndef RESTLINK_PLUGININDEX_P_H
+#define RESTLINK_PLUGININDEX_P_H
+
+#include <RestLink/global.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qjsonobject.h>
+
+class QFileInfo;
+
+namespace RestLink {
+
+class PluginIndex
+{
+public:
+    struct Entry {
+        QString fileName;
+        qint64 modified = 0;
+        qint64 size = 0;
+        QString iid;
+        QJsonObject metaData;
+
+        bool isPlugin() const;
+        QString name() const;
+        QStringList schemes() const;
+    };
+
+    PluginIndex();
+
+    QList<Entry> scan(const QStringList &names, bool discovery);
+
+    bool load();
+    bool save();
+
+private:
+    Entry entry(const QFileInfo &file);
+
+    QString m_fileName;
+    QHash<QString, Entry> m_entries;
+    bool m_loaded;
+    bool m_dirty;
+};
+
+} // namespace RestLink
+
+#endif // RESTLINK_PLUGININDEX_P_H
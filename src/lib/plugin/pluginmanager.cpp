@@ -5,9 +5,7 @@
 #include <RestLink/abstractrequesthandler.h>
 
 #include <QtCore/qcoreapplication.h>
-#include <QtCore/qdiriterator.h>
-#include <QtCore/qdir.h>
-#include <QtCore/qlibrary.h>
+#include <QtCore/qthread.h>
 
 namespace RestLink {
 
@@ -24,17 +22,24 @@ namespace RestLink {
  * with caution and only in trusted environments, use enableDiscovery() to explicitly enable discovery,
  * alternatively, use the static registerPlugin() method to securely specify which plugins should be loaded by name,
  * bypassing the need for unrestricted path scanning.
+ *
+ * All static methods are thread-safe. Handler lookups don't lock the registry, they read an
+ * immutable snapshot of it that gets replaced whenever plugins or handlers change. Plugin
+ * handlers are created by the thread needing them first, then handed over to the application
+ * thread, which owns them, without ever waiting for it.
  */
 
 /**
  * @brief Constructs a new PluginManager instance.
  */
 PluginManager::PluginManager()
-    : d_ptr(new PluginManagerPrivate)
+    : d_ptr(new PluginManagerPrivate(this))
 {
 #ifdef RESTLINK_SUPPORT_SQL
     d_ptr->names.append("restlinksql");
 #endif
+
+    d_ptr->publish(false);
 }
 
 /**
@@ -46,64 +51,140 @@ PluginManager::~PluginManager()
 
 /**
  * @brief Returns a list of all discovered and valid AbstractRequestHandler instances.
+ *
+ * Handlers that were not needed yet get created, prefer handler() to only create the one
+ * handling a given scheme.
+ *
  * @return QList of AbstractRequestHandler pointers.
  */
 QList<AbstractRequestHandler *> PluginManager::handlers()
 {
-    static QList<AbstractRequestHandler *> handlers;
-    if (!handlers.isEmpty())
-        return handlers;
+    PluginManagerPrivate *data = global()->d_ptr.get();
+    const std::shared_ptr<const PluginManagerPrivate::Snapshot> snapshot = data->indexedSnapshot();
+
+    // Nothing to create, the snapshot is up to date
+    auto pending = std::find_if(snapshot->routes.cbegin(), snapshot->routes.cend(), [](const PluginManagerPrivate::Snapshot::Route &route) {
+        return !route.handler;
+    });
+    if (pending == snapshot->routes.cend())
+        return snapshot->handlers;
+
+    QMutexLocker locker(&data->mutex);
+    bool changed = false;
+    for (PluginManagerPrivate::Handler &plugin : data->plugins) {
+        changed |= !plugin.created;
+        data->create(&plugin);
+    }
 
-// Plugins disabled for WASM
-#ifdef Q_OS_WASM
-    return handlers;
-#endif
+    if (changed)
+        data->publish();
+    return data->currentSnapshot()->handlers;
+}
 
-    PluginManager *manager = global();
-    PluginManagerPrivate *data = manager->d_ptr.get();
-
-    QStringList fileNames;
-    auto processDir = [data, &fileNames](const QFileInfo &entry) {
-        const QDir dir(entry.absoluteFilePath());
-        const QFileInfoList files = dir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
-        for (const QFileInfo &file : files) {
-            if (!QLibrary::isLibrary(file.fileName()))
-                continue;
-
-            for (const QString &pluginName : std::as_const(data->names)) {
-                if (file.baseName() == pluginName) {
-                    fileNames.append(file.absoluteFilePath());
-                    continue;
-                }
-            }
-
-            if (data->discoveryEnabled)
-                fileNames.append(file.absoluteFilePath());
-        }
-    };
+/**
+ * @brief Returns the handler supporting \a scheme, or nullptr if no plugin supports it.
+ *
+ * Plugins declaring their schemes in their metadata get their handler created by the first
+ * call for one of these schemes, other plugins get it created as soon as they are found.
+ */
+AbstractRequestHandler *PluginManager::handler(const QString &scheme)
+{
+    PluginManagerPrivate *data = global()->d_ptr.get();
+    const std::shared_ptr<const PluginManagerPrivate::Snapshot> snapshot = data->indexedSnapshot();
 
-    const QStringList searchPaths = QCoreApplication::libraryPaths();
-    for (const QString &path : searchPaths) {
-        QDirIterator it(path, { "restlink" }, QDir::Dirs, QDirIterator::Subdirectories);
-        while (it.hasNext())
-            processDir(it.nextFileInfo());
+    auto it = snapshot->routes.constFind(scheme);
+    if (it == snapshot->routes.constEnd())
+        return nullptr;
+
+    if (it->handler)
+        return it->handler;
+
+    // The plugin handler has to be created, it may have been since the snapshot was taken
+    QMutexLocker locker(&data->mutex);
+    PluginManagerPrivate::Handler *plugin = &data->plugins[it->plugin];
+    if (!plugin->created) {
+        data->create(plugin);
+        data->publish();
     }
 
-    for (const QString &fileName : std::as_const(fileNames)) {
-        // loading plugin
-        Plugin *plugin = manager->loadPlugin(fileName);
-        if (!plugin)
-            continue;
+    return (plugin->schemes.contains(scheme) ? plugin->handler : nullptr);
+}
 
-        // Retrieve handler
-        AbstractRequestHandler *handler = manager->createHandler(plugin);
-        if (handler)
-            handlers.append(handler);
+/**
+ * @brief Returns the schemes supported by plugins.
+ *
+ * Schemes are read from plugin metadata, which doesn't require loading plugins, once a handler
+ * is created, its supported schemes are used instead.
+ */
+QStringList PluginManager::schemes()
+{
+    return global()->d_ptr->indexedSnapshot()->schemes;
+}
 
-        manager->unloadPlugin();
+/**
+ * @brief Registers an in-process \a handler for the schemes it supports.
+ *
+ * Registered handlers take precedence over plugins for their schemes. The handler isn't owned
+ * by the plugin manager, it must be unregistered before being deleted, and since it might be
+ * used from any thread at once, it has to be thread-safe if requests get sent from several threads.
+ *
+ * @return true if the handler has been registered, false otherwise.
+ */
+bool PluginManager::registerHandler(AbstractRequestHandler *handler)
+{
+    const QStringList schemes = handler->supportedSchemes();
+    if (schemes.contains("http", Qt::CaseInsensitive) || schemes.contains("https", Qt::CaseInsensitive)) {
+        restlinkWarning() << "an HTTP/HTTPS handler can't be registered, this is unsuported for security reasons";
+        return false;
     }
 
-    return handlers;
+    PluginManagerPrivate *data = global()->d_ptr.get();
+    QMutexLocker locker(&data->mutex);
+    if (data->registeredHandlers.contains(handler))
+        return true;
+
+    data->registeredHandlers.append(handler);
+    data->publish(data->currentSnapshot()->indexed);
+    return true;
+}
+
+/**
+ * @brief Unregisters a \a handler previously registered with registerHandler().
+ *
+ * Requests already dispatched to the handler are not affected, the caller must make sure they
+ * are done before deleting it.
+ */
+void PluginManager::unregisterHandler(AbstractRequestHandler *handler)
+{
+    PluginManagerPrivate *data = global()->d_ptr.get();
+    QMutexLocker locker(&data->mutex);
+    if (data->registeredHandlers.removeAll(handler))
+        data->publish(data->currentSnapshot()->indexed);
+}
+
+/**
+ * @brief Starts looking for plugins on a background thread.
+ *
+ * Only plugin metadata gets read, handlers are still created on first use. Calling this
+ * right after the application object creation spares the scan to the first request.
+ */
+void PluginManager::preload()
+{
+    PluginManagerPrivate *data = global()->d_ptr.get();
+    QMutexLocker locker(&data->mutex);
+    if (!data->currentSnapshot()->indexed && !data->pendingScan.valid())
+        data->startScan();
+}
+
+/**
+ * @brief Returns a number that changes whenever the list of handlers may have changed.
+ *
+ * Handler lookups can be cached as long as this value stays the same, handlers() must
+ * be called again to get the up to date list once it changed.
+ */
+quint64 PluginManager::revision()
+{
+    return global()->d_ptr->currentSnapshot()->revision;
 }
 
 /**
@@ -112,7 +193,9 @@ QList<AbstractRequestHandler *> PluginManager::handlers()
  */
 bool PluginManager::isDiscoveryEnabled()
 {
-    return global()->d_ptr->discoveryEnabled;
+    PluginManagerPrivate *data = global()->d_ptr.get();
+    QMutexLocker locker(&data->mutex);
+    return data->discoveryEnabled;
 }
 
 /**
@@ -127,7 +210,7 @@ bool PluginManager::isDiscoveryEnabled()
  */
 void PluginManager::enableDiscovery()
 {
-    global()->d_ptr->discoveryEnabled = true;
+    setDiscoveryEnabled(true);
 }
 
 /**
@@ -136,7 +219,14 @@ void PluginManager::enableDiscovery()
  */
 void PluginManager::setDiscoveryEnabled(bool enable)
 {
-    global()->d_ptr->discoveryEnabled = enable;
+    PluginManagerPrivate *data = global()->d_ptr.get();
+    QMutexLocker locker(&data->mutex);
+    if (data->discoveryEnabled == enable)
+        return;
+
+    data->discoveryEnabled = enable;
+    if (enable)
+        data->invalidate();
 }
 
 /**
@@ -149,9 +239,12 @@ void PluginManager::setDiscoveryEnabled(bool enable)
  */
 void PluginManager::registerPlugin(const QString &name)
 {
-    QStringList *names = &global()->d_ptr->names;
-    if (!names->contains(name))
-        names->append(name);
+    PluginManagerPrivate *data = global()->d_ptr.get();
+    QMutexLocker locker(&data->mutex);
+    if (!data->names.contains(name)) {
+        data->names.append(name);
+        data->invalidate();
+    }
 }
 
 /**
@@ -242,4 +335,162 @@ PluginManager *PluginManager::global()
     return &manager;
 }
 
+PluginManagerPrivate::PluginManagerPrivate(PluginManager *q)
+    : q_ptr(q)
+{
+}
+
+PluginManagerPrivate::~PluginManagerPrivate()
+{
+    // A pending scan uses the index, it must be done before it goes away
+    if (pendingScan.valid())
+        pendingScan.wait();
+}
+
+std::shared_ptr<const PluginManagerPrivate::Snapshot> PluginManagerPrivate::currentSnapshot() const
+{
+    return std::atomic_load_explicit(&snapshot, std::memory_order_acquire);
+}
+
+std::shared_ptr<const PluginManagerPrivate::Snapshot> PluginManagerPrivate::indexedSnapshot()
+{
+    std::shared_ptr<const Snapshot> current = currentSnapshot();
+    if (current->indexed)
+        return current;
+
+    QMutexLocker locker(&mutex);
+    if (!currentSnapshot()->indexed)
+        index();
+    return currentSnapshot();
+}
+
+void PluginManagerPrivate::index()
+{
+// Plugins disabled for WASM
+#ifdef Q_OS_WASM
+    publish();
+    return;
+#endif
+
+    QList<PluginIndex::Entry> entries;
+    bool scanned = false;
+    if (pendingScan.valid()) {
+        entries = pendingScan.get();
+        scanned = (pendingNames == names && pendingDiscovery == discoveryEnabled);
+    }
+
+    // Results of a scan started with another configuration can't be used, the index is warm though
+    if (!scanned)
+        entries = pluginIndex.scan(names, discoveryEnabled);
+
+    for (const PluginIndex::Entry &entry : entries) {
+        auto it = std::find_if(plugins.cbegin(), plugins.cend(), [&entry](const Handler &plugin) {
+            return plugin.entry.fileName == entry.fileName;
+        });
+
+        if (it != plugins.cend())
+            continue;
+
+        Handler plugin;
+        plugin.entry = entry;
+        plugin.schemes = entry.schemes();
+        plugins.append(plugin);
+
+        // Without declared schemes, the handler has to tell us
+        if (plugin.schemes.isEmpty())
+            create(&plugins.last());
+    }
+
+    publish();
+}
+
+void PluginManagerPrivate::startScan()
+{
+    pendingNames = names;
+    pendingDiscovery = discoveryEnabled;
+    pendingScan = std::async(std::launch::async, [this, names = names, discovery = discoveryEnabled] {
+        return pluginIndex.scan(names, discovery);
+    });
+}
+
+PluginManagerPrivate::Handler *PluginManagerPrivate::create(Handler *plugin)
+{
+    if (plugin->created)
+        return (plugin->handler ? plugin : nullptr);
+    plugin->created = true;
+
+    // loading plugin
+    Plugin *instance = q_ptr->loadPlugin(plugin->entry.fileName);
+    if (instance) {
+        // Retrieve handler
+        plugin->handler = q_ptr->createHandler(instance);
+        q_ptr->unloadPlugin();
+        adopt(plugin->handler);
+    }
+
+    plugin->schemes = (plugin->handler ? plugin->handler->supportedSchemes() : QStringList());
+    return (plugin->handler ? plugin : nullptr);
+}
+
+void PluginManagerPrivate::publish(bool indexed)
+{
+    std::shared_ptr<Snapshot> next = std::make_shared<Snapshot>();
+    next->revision = ++revision;
+    next->indexed = indexed;
+
+    auto addRoute = [&next](const QString &scheme, AbstractRequestHandler *handler, qsizetype plugin) {
+        if (next->routes.contains(scheme))
+            return;
+        next->routes.insert(scheme, { handler, plugin });
+        next->schemes.append(scheme);
+    };
+
+    for (AbstractRequestHandler *handler : std::as_const(registeredHandlers)) {
+        const QStringList schemes = handler->supportedSchemes();
+        for (const QString &scheme : schemes)
+            addRoute(scheme, handler, -1);
+        next->handlers.append(handler);
+    }
+
+    if (indexed) {
+        for (qsizetype i(0); i < plugins.size(); ++i) {
+            const Handler &plugin = plugins.at(i);
+            for (const QString &scheme : plugin.schemes)
+                addRoute(scheme, plugin.handler, i);
+            if (plugin.handler)
+                next->handlers.append(plugin.handler);
+        }
+    }
+
+    std::atomic_store_explicit(&snapshot, std::shared_ptr<const Snapshot>(std::move(next)), std::memory_order_release);
+}
+
+void PluginManagerPrivate::invalidate()
+{
+    publish(false);
+}
+
+void PluginManagerPrivate::adopt(AbstractRequestHandler *handler)
+{
+    QObject *object = dynamic_cast<QObject *>(handler);
+    QCoreApplication *app = QCoreApplication::instance();
+    if (!object || !app || object->parent())
+        return;
+
+    if (isApplicationThread()) {
+        object->setParent(app);
+        return;
+    }
+
+    // The creating thread may end before the handler, the application takes it over when it can
+    object->moveToThread(app->thread());
+    QMetaObject::invokeMethod(app, [object, app] { object->setParent(app); }, Qt::QueuedConnection);
+}
+
+bool PluginManagerPrivate::isApplicationThread()
+{
+    const QCoreApplication *app = QCoreApplication::instance();
+    return !app || QThread::currentThread() == app->thread();
+}
+
 } // namespace RestLink
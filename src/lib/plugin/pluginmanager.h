@@ -14,6 +14,11 @@ public:
     ~PluginManager();
 
     static QList<AbstractRequestHandler *> handlers();
+    static AbstractRequestHandler *handler(const QString &scheme);
+    static QStringList schemes();
+    static quint64 revision();
+
+    static void preload();
 
     static bool isDiscoveryEnabled();
     static void enableDiscovery();
@@ -21,6 +26,9 @@ public:
 
     static void registerPlugin(const QString &name);
 
+    static bool registerHandler(AbstractRequestHandler *handler);
+    static void unregisterHandler(AbstractRequestHandler *handler);
+
     static PluginManager *global();
 
 private:
@@ -29,6 +37,8 @@ private:
     void unloadPlugin();
 
     QScopedPointer<PluginManagerPrivate> d_ptr;
+
+    friend class PluginManagerPrivate;
 };
 
 } // namespace RestLink
@@ -1,19 +1,80 @@
 #ifndef RESTLINK_PLUGINMANAGER_P_H
 #define RESTLINK_PLUGINMANAGER_P_H
 
+#include "pluginindex_p.h"
+
 #include <QtCore/qlist.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
 #include <QtCore/qpluginloader.h>
 
+#include <future>
+#include <memory>
+
 namespace RestLink {
 
 class AbstractRequestHandler;
+class PluginManager;
 
 class PluginManagerPrivate
 {
 public:
+    struct Handler {
+        PluginIndex::Entry entry;
+        QStringList schemes; // Declared by metadata until the handler gets created
+        AbstractRequestHandler *handler = nullptr;
+        bool created = false;
+    };
+
+    // What readers see, never modified once published
+    struct Snapshot {
+        struct Route {
+            AbstractRequestHandler *handler = nullptr; // nullptr until the plugin handler gets created
+            qsizetype plugin = -1;
+        };
+
+        QHash<QString, Route> routes;
+        QStringList schemes;
+        QList<AbstractRequestHandler *> handlers;
+        quint64 revision = 0;
+        bool indexed = false;
+    };
+
+    PluginManagerPrivate(PluginManager *q);
+    ~PluginManagerPrivate();
+
+    std::shared_ptr<const Snapshot> currentSnapshot() const;
+    std::shared_ptr<const Snapshot> indexedSnapshot();
+
+    void index();
+    void startScan();
+    Handler *create(Handler *plugin);
+    void publish(bool indexed = true);
+    void invalidate();
+
+    static void adopt(AbstractRequestHandler *handler);
+    static bool isApplicationThread();
+
+    PluginManager *q_ptr;
+
+    // Only accessed atomically, readers keep older ones alive as long as they use them
+    std::shared_ptr<const Snapshot> snapshot;
+
+    // Everything below is guarded by mutex
+    QMutex mutex;
+
     QStringList names;
     bool discoveryEnabled = false;
-    QList<AbstractRequestHandler *> handlers;
+
+    QList<Handler> plugins;
+    QList<AbstractRequestHandler *> registeredHandlers;
+    quint64 revision = 0;
+
+    // Metadata scan, possibly running on a background thread
+    PluginIndex pluginIndex;
+    std::future<QList<PluginIndex::Entry>> pendingScan;
+    QStringList pendingNames;
+    bool pendingDiscovery = false;
 
     QPluginLoader pluginLoader;
 };
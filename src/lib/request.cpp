@@ -145,7 +145,7 @@ Request::Request(const Request &other) :
  * \param other The Request object to move from.
  */
 Request::Request(Request &&other) :
-    d_ptr(other.d_ptr)
+    d_ptr(std::move(other.d_ptr))
 {
 }
 
@@ -253,10 +253,6 @@ QUrl Request::url(UrlType type) const
         return RequestPrivate::canUseUrlParameter(param, type);
     };
 
-    auto parameterValues = [&api](const Parameter &param) {
-        return (api ? param.specialValues(api) : param.values());
-    };
-
     url.setPath(url.path() + d_ptr->generateUrlPath(type));
 
     QUrlQuery query(url.query());
@@ -266,9 +262,9 @@ QUrl Request::url(UrlType type) const
         if (!canUseParameter(parameter))
             continue;
 
-        const QVariantList values = parameterValues(parameter);
-        for (const QVariant &value : values)
-            query.addQueryItem(parameter.name(), value.toString());
+        const QString name = parameter.name();
+        for (qsizetype i(0); i < parameter.valueCount(); ++i)
+            query.addQueryItem(name, parameter.specialText(api, i));
     }
     url.setQuery(query);
 
@@ -298,12 +294,22 @@ QHttpHeaders Request::httpHeaders() const
     const HeaderList apiHeaders = (api ? api->headers() : HeaderList());
     const HeaderList headers = d_ptr->headers + apiHeaders;
     for (const Header &header : headers) {
-        if (httpHeaders.contains(header.name()))
-            httpHeaders.removeAll(header.name());
+        if (header.isWellKnown()) {
+            const QHttpHeaders::WellKnownHeader name = header.wellKnownName();
+            if (httpHeaders.contains(name))
+                httpHeaders.removeAll(name);
 
-        const QVariantList values = header.values();
-        for (const QVariant &value : values)
-            httpHeaders.append(header.name(), value.toByteArray());
+            for (qsizetype i(0); i < header.valueCount(); ++i)
+                httpHeaders.append(name, header.text(i));
+            continue;
+        }
+
+        const QString name = header.name();
+        if (httpHeaders.contains(name))
+            httpHeaders.removeAll(name);
+
+        for (qsizetype i(0); i < header.valueCount(); ++i)
+            httpHeaders.append(name, header.text(i));
     }
 
     if (!api)
@@ -490,7 +496,22 @@ void Request::swap(Request &other)
  */
 Request Request::merge(const Request &r1, const Request &r2)
 {
-    Request request = r1;
+    return merge(Request(r1), r2);
+}
+
+/*!
+ * \brief Merges \a r2 into \a r1, taking over its data.
+ *
+ * This overload avoids copying \a r1 when the caller doesn't need it anymore,
+ * the merge happens in place unless \a r1 data is shared with another request.
+ *
+ * \param r1 The Request to merge into.
+ * \param r2 The Request to merge from.
+ * \return The merged Request.
+ */
+Request Request::merge(Request &&r1, const Request &r2)
+{
+    Request request(std::move(r1));
 
     // Adding base url from r2 if not present on r1
     if (!request.baseUrl().isEmpty())
@@ -555,15 +576,10 @@ QString RequestPrivate::generateUrlPath(Request::UrlType type) const
     const PathParameterList pathParameters = this->pathParameters + apiPathParameters;
     for (const PathParameter &parameter : pathParameters)
         if (canUseUrlParameter(parameter, type))
-            path.replace('{' + parameter.name() + '}', parameterValue(parameter).toString());
+            path.replace('{' + parameter.name() + '}', parameter.specialText(api));
     return path;
 }
 
-QVariant RequestPrivate::parameterValue(const Parameter &parameter) const
-{
-    return (api ? parameter.specialValue(api) : parameter.value());
-}
-
 QString RequestPrivate::validateEndpoint(const QString &input)
 {
     return input;
@@ -77,6 +77,7 @@ public:
     void swap(Request &other);
 
     static Request merge(const Request &r1, const Request &r2);
+    static Request merge(Request &&r1, const Request &r2);
 
 protected:
     Request(RequestPrivate *d);
@@ -92,6 +93,7 @@ private:
     QList<Header> *mutableHeaders() override;
 
     friend class ApiBase;
+    friend class ApiBasePrivate;
     friend class Api;
     friend class ServerRequest;
 };
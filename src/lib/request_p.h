@@ -20,7 +20,6 @@ public:
     virtual ~RequestPrivate() = default;
 
     QString generateUrlPath(Request::UrlType type) const;
-    QVariant parameterValue(const Parameter &parameter) const;
 
     virtual RequestPrivate *clone() const
     { return new RequestPrivate(*this); }
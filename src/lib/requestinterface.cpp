@@ -91,6 +91,7 @@ void RequestInterface::setPathParameter(const QString &name, const QVariant &val
         it->setValue(value);
     else
         mutablePathParameters()->append(PathParameter(name, value));
+    parametersChanged();
 }
 
 /**
@@ -117,6 +118,7 @@ void RequestInterface::unsetPathParameter(const QString &name)
     auto it = findPathParameter(name);
     if (it != mutablePathParameters()->end())
         mutablePathParameters()->removeAt(std::distance(mutablePathParameters()->begin(), it));
+    parametersChanged();
 }
 
 /**
@@ -140,6 +142,7 @@ QList<PathParameter> RequestInterface::pathParameters() const {
 void RequestInterface::setPathParameters(const QList<PathParameter> &parameters)
 {
     *mutablePathParameters() = parameters;
+    parametersChanged();
 }
 
 /**
@@ -219,6 +222,7 @@ void RequestInterface::addQueryParameter(const QString &name, const QVariant &va
         it->addValue(value);
     else
         mutableQueryParameters()->append(QueryParameter(name, value));
+    parametersChanged();
 }
 
 /**
@@ -236,6 +240,7 @@ void RequestInterface::addQueryParameter(const QueryParameter &param)
             it->addValue(value);
     else
         mutableQueryParameters()->append(param);
+    parametersChanged();
 }
 
 /**
@@ -250,6 +255,7 @@ void RequestInterface::removeQueryParameter(const QString &name)
     auto it = findQueryParameter(name);
     if (it != mutableQueryParameters()->end())
         mutableQueryParameters()->removeAt(std::distance(mutableQueryParameters()->begin(), it));
+    parametersChanged();
 }
 
 
@@ -265,6 +271,7 @@ void RequestInterface::removeQueryParameter(const QString &name, const QVariant
     auto it = findQueryParameter(name);
     if (it != mutableQueryParameters()->end())
         it->removeValue(value);
+    parametersChanged();
 }
 
 /**
@@ -289,6 +296,7 @@ QList<QueryParameter> RequestInterface::queryParameters() const
 void RequestInterface::setQueryParameters(const QList<QueryParameter> &parameters)
 {
     *mutableQueryParameters() = parameters;
+    parametersChanged();
 }
 
 /**
@@ -366,6 +374,7 @@ void RequestInterface::setHeader(const QString &name, const QVariant &value)
         it->addValue(value);
     else
         mutableHeaders()->append(Header(name, value));
+    parametersChanged();
 }
 
 /**
@@ -382,6 +391,7 @@ void RequestInterface::setHeader(const Header &header)
         *it = header;
     else
         mutableHeaders()->append(header);
+    parametersChanged();
 }
 
 /**
@@ -396,6 +406,7 @@ void RequestInterface::unsetHeader(const QString &name)
     auto it = findHeader(name);
     if (it != mutableHeaders()->end())
         mutableHeaders()->removeAt(std::distance(mutableHeaders()->begin(), it));
+    parametersChanged();
 }
 
 /**
@@ -420,6 +431,16 @@ QList<Header> RequestInterface::headers() const
 void RequestInterface::setHeaders(const QList<Header> &headers)
 {
     *this->mutableHeaders() = headers;
+    parametersChanged();
+}
+
+/**
+ * @brief Called after parameters or headers got changed through this interface.
+ *
+ * The default implementation does nothing.
+ */
+void RequestInterface::parametersChanged()
+{
 }
 
 /**
@@ -432,8 +453,9 @@ void RequestInterface::setHeaders(const QList<Header> &headers)
  */
 QList<PathParameter>::const_iterator RequestInterface::findPathParameter(const QString &name) const
 {
-    return std::find_if(constPathParameters()->begin(), constPathParameters()->end(), [name](const PathParameter &parameter) {
-        return parameter.name() == name;
+    const uint hash = Parameter::hashName(name);
+    return std::find_if(constPathParameters()->begin(), constPathParameters()->end(), [&name, hash](const PathParameter &parameter) {
+        return parameter.nameHash() == hash && parameter.name() == name;
     });
 }
 
@@ -447,8 +469,9 @@ QList<PathParameter>::const_iterator RequestInterface::findPathParameter(const Q
  */
 QList<PathParameter>::iterator RequestInterface::findPathParameter(const QString &name)
 {
-    return std::find_if(mutablePathParameters()->begin(), mutablePathParameters()->end(), [name](const PathParameter &parameter) {
-        return parameter.name() == name;
+    const uint hash = Parameter::hashName(name);
+    return std::find_if(mutablePathParameters()->begin(), mutablePathParameters()->end(), [&name, hash](const PathParameter &parameter) {
+        return parameter.nameHash() == hash && parameter.name() == name;
     });
 }
 
@@ -462,8 +485,9 @@ QList<PathParameter>::iterator RequestInterface::findPathParameter(const QString
  */
 QList<QueryParameter>::const_iterator RequestInterface::findQueryParameter(const QString &name) const
 {
-    return std::find_if(constQueryParameters()->begin(), constQueryParameters()->end(), [name](const QueryParameter &parameter) {
-        return parameter.name() == name;
+    const uint hash = Parameter::hashName(name);
+    return std::find_if(constQueryParameters()->begin(), constQueryParameters()->end(), [&name, hash](const QueryParameter &parameter) {
+        return parameter.nameHash() == hash && parameter.name() == name;
     });
 }
 
@@ -477,8 +501,9 @@ QList<QueryParameter>::const_iterator RequestInterface::findQueryParameter(const
  */
 QList<QueryParameter>::iterator RequestInterface::findQueryParameter(const QString &name)
 {
-    return std::find_if(mutableQueryParameters()->begin(), mutableQueryParameters()->end(), [name](const QueryParameter &parameter) {
-        return parameter.name() == name;
+    const uint hash = Parameter::hashName(name);
+    return std::find_if(mutableQueryParameters()->begin(), mutableQueryParameters()->end(), [&name, hash](const QueryParameter &parameter) {
+        return parameter.nameHash() == hash && parameter.name() == name;
     });
 }
 
@@ -492,8 +517,13 @@ QList<QueryParameter>::iterator RequestInterface::findQueryParameter(const QStri
  */
 QList<Header>::const_iterator RequestInterface::findHeader(const QString &name) const
 {
-    return std::find_if(constHeaders()->begin(), constHeaders()->end(), [name](const Header &header) {
-        return header.name() == name;
+    // Header names are case insensitive, well known ones are matched by id
+    const uint hash = Parameter::hashName(name);
+    const int id = Header::idOf(name);
+    return std::find_if(constHeaders()->begin(), constHeaders()->end(), [&name, hash, id](const Header &header) {
+        if (id >= 0)
+            return header.id() == id;
+        return header.nameHash() == hash && header.name().compare(name, Qt::CaseInsensitive) == 0;
     });
 }
 
@@ -506,8 +536,13 @@ QList<Header>::const_iterator RequestInterface::findHeader(const QString &name)
  */
 QList<Header>::iterator RequestInterface::findHeader(const QString &name)
 {
-    return std::find_if(mutableHeaders()->begin(), mutableHeaders()->end(), [name](const Header &header) {
-        return header.name() == name;
+    // Header names are case insensitive, well known ones are matched by id
+    const uint hash = Parameter::hashName(name);
+    const int id = Header::idOf(name);
+    return std::find_if(mutableHeaders()->begin(), mutableHeaders()->end(), [&name, hash, id](const Header &header) {
+        if (id >= 0)
+            return header.id() == id;
+        return header.nameHash() == hash && header.name().compare(name, Qt::CaseInsensitive) == 0;
     });
 }
 
@@ -49,6 +49,8 @@ public:
     void setHeaders(const QList<Header> &headers);
 
 protected:
+    virtual void parametersChanged();
+
     virtual const QList<PathParameter> *constPathParameters() const = 0;
     virtual QList<PathParameter> *mutablePathParameters() = 0;
 
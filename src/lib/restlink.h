@@ -18,6 +18,7 @@
 #include <RestLink/header.h>
 #include <RestLink/body.h>
 #include <RestLink/response.h>
+#include <RestLink/deferredresponse.h>
 
 #include <RestLink/cache.h>
 #include <RestLink/cookiejar.h>
@@ -26,6 +27,7 @@
 #include <RestLink/pluginmanager.h>
 
 #include <RestLink/abstractrequestinterceptor.h>
+#include <RestLink/abstracttokenprovider.h>
 
 #include <RestLink/httputils.h>
 #include <RestLink/compressionutils.h>
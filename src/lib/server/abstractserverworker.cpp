@@ -122,9 +122,12 @@ AbstractServerWorkerPrivate::~AbstractServerWorkerPrivate()
 void AbstractServerWorkerPrivate::syncRun(int interval)
 {
     while (!q_ptr->isInterruptionRequested()) {
-        if (!processNext())
-            if (!q_ptr->maintain())
-                return;
+        // Queued requests are processed back to back, we only wait when idle
+        if (processNext())
+            continue;
+
+        if (!q_ptr->maintain())
+            return;
         q_ptr->msleep(interval);
     }
 }
@@ -134,11 +137,17 @@ void AbstractServerWorkerPrivate::assyncRun(int interval)
     QTimer timer;
     timer.start(interval);
 
-    QObject::connect(&timer, &QTimer::timeout, &timer, [this] {
+    QObject::connect(&timer, &QTimer::timeout, &timer, [this, &timer, interval] {
         if (!q_ptr->isInterruptionRequested()) {
-            if (!processNext())
-                if (!q_ptr->maintain())
-                    q_ptr->quit();
+            // Events get a chance to run between queued requests
+            if (processNext()) {
+                timer.setInterval(0);
+                return;
+            }
+
+            timer.setInterval(interval);
+            if (!q_ptr->maintain())
+                q_ptr->quit();
         } else {
             q_ptr->quit();
         }
@@ -159,6 +168,10 @@ bool AbstractServerWorkerPrivate::processNext()
             pending = pendingRequests.dequeue();
     }
 
+    // Aborted while waiting, nobody expects anything from it
+    if (pending.response->isAborted())
+        return true;
+
     AbstractController *controller = pending.request.controller();
     if (!controller) {
         auto it = std::find_if(controllers.begin(), controllers.end(), [&pending](AbstractController *controller) {
@@ -180,7 +193,7 @@ bool AbstractServerWorkerPrivate::processNext()
         q_ptr->processStandardRequest(pending.request, pending.response);
     }
 
-    if (pending.response->isRunning())
+    if (pending.response->isRunning() && !pending.response->isDeferred())
         pending.response->complete();
 
     return true;
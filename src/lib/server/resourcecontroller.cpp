@@ -95,7 +95,7 @@ void AbstractResourceController::processRequest(const ServerRequest &request, Se
         return;
     }
 
-    if (method == AbstractRequestHandler::PutMethod) {
+    if (method == AbstractRequestHandler::PutMethod || method == AbstractRequestHandler::PatchMethod) {
         update(request, response);
         return;
     }
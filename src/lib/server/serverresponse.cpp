@@ -7,6 +7,13 @@
 #include <QtCore/qjsonobject.h>
 #include <QtCore/qjsonarray.h>
 #include <QtCore/qtimer.h>
+#include <QtCore/qdeadlinetimer.h>
+
+#include <QtNetwork/qnetworkreply.h>
+
+// Bytes a streamed body may buffer ahead of a client reading it
+#define STREAM_BUFFER_LIMIT (1024 * 1024)
+#define STREAM_WAIT_TIMEOUT 30000
 
 namespace RestLink {
 
@@ -15,6 +22,9 @@ ServerResponse::ServerResponse(Server *server)
 {
     RESTLINK_D(ServerResponse);
     d->server = server;
+
+    // Streamed bodies are read straight from the response
+    setOpenMode(QIODevice::ReadOnly | QIODevice::Unbuffered);
 }
 
 ServerResponse::~ServerResponse()
@@ -42,6 +52,33 @@ bool ServerResponse::isFinished() const
     return d->finished;
 }
 
+bool ServerResponse::isAborted() const
+{
+    RESTLINK_D(const ServerResponse);
+    QReadLocker locker(&d->lock);
+    return d->aborted;
+}
+
+/*!
+ * \brief Marks the response as completed later on.
+ *
+ * Workers complete responses left running once a request got processed, deferred ones are
+ * left untouched, whoever deferred them is responsible for calling complete().
+ */
+void ServerResponse::defer()
+{
+    RESTLINK_D(ServerResponse);
+    QWriteLocker locker(&d->lock);
+    d->deferred = true;
+}
+
+bool ServerResponse::isDeferred() const
+{
+    RESTLINK_D(const ServerResponse);
+    QReadLocker locker(&d->lock);
+    return d->deferred;
+}
+
 int ServerResponse::httpStatusCode() const
 {
     RESTLINK_D(const ServerResponse);
@@ -94,32 +131,32 @@ void ServerResponse::setHeaders(const QList<Header> &headers)
     d->headers = headers.toVector();
 }
 
+int ServerResponse::networkError() const
+{
+    RESTLINK_D(const ServerResponse);
+    QReadLocker locker(&d->lock);
+    return d->networkError;
+}
+
 QJsonObject ServerResponse::readJsonObject(QJsonParseError *error)
 {
     RESTLINK_D(ServerResponse);
     QWriteLocker locker(&d->lock);
-    return (d->body.hasJsonObject() ? d->readBody().jsonObject() : QJsonObject());
+    return (d->hasJsonBody() ? d->readJson(error).toObject() : QJsonObject());
 }
 
 QJsonArray ServerResponse::readJsonArray(QJsonParseError *error)
 {
     RESTLINK_D(ServerResponse);
     QWriteLocker locker(&d->lock);
-    return (d->body.hasJsonArray() ? d->readBody().jsonArray() : QJsonArray());
+    return (d->hasJsonBody() ? d->readJson(error).toArray() : QJsonArray());
 }
 
 QJsonValue ServerResponse::readJson(QJsonParseError *error)
 {
     RESTLINK_D(ServerResponse);
     QWriteLocker locker(&d->lock);
-
-    if (d->body.hasJsonObject())
-        return d->readBody().jsonObject();
-
-    if (d->body.hasJsonArray())
-        return d->readBody().jsonArray();
-
-    return QJsonValue();
+    return d->readJson(error);
 }
 
 QString ServerResponse::readString()
@@ -143,6 +180,99 @@ void ServerResponse::setBody(const Body &body)
     d->body = body;
 }
 
+/*!
+ * \brief Appends data to a streamed body.
+ *
+ * Written data is readable right away and readyRead() is emitted, so that clients can consume
+ * bodies while they are being produced. Once a client started reading, writing blocks as long
+ * as too much data is waiting to be read. The content type is the one of the body previously
+ * set using setBody(), if any.
+ *
+ * A client that stops reading for too long gets the response aborted with a timeout error.
+ * Returns false once the response is aborted, workers should then stop producing data.
+ */
+bool ServerResponse::writeBody(const QByteArray &data)
+{
+    RESTLINK_D(ServerResponse);
+
+    bool timedOut = false;
+
+    {
+        QWriteLocker locker(&d->lock);
+        if (d->aborted)
+            return false;
+
+        d->streamed = true;
+
+        // Clients reading only once finished must get everything
+        const QDeadlineTimer deadline(STREAM_WAIT_TIMEOUT);
+        while (!timedOut && !d->aborted && d->streamRead && d->stream.size() >= STREAM_BUFFER_LIMIT)
+            timedOut = !d->streamConsumed.wait(&d->lock, deadline);
+
+        if (d->aborted)
+            return false;
+
+        if (timedOut) {
+            d->aborted = true;
+            d->networkError = QNetworkReply::TimeoutError;
+        } else {
+            d->stream.append(data);
+        }
+    }
+
+    if (timedOut) {
+        emit networkErrorOccured(QNetworkReply::TimeoutError);
+        complete();
+        return false;
+    }
+
+    emit readyRead();
+    return true;
+}
+
+bool ServerResponse::isStreamed() const
+{
+    RESTLINK_D(const ServerResponse);
+    QReadLocker locker(&d->lock);
+    return d->streamed;
+}
+
+bool ServerResponse::isSequential() const
+{
+    return true;
+}
+
+qint64 ServerResponse::pos() const
+{
+    return QIODevice::pos();
+}
+
+qint64 ServerResponse::size() const
+{
+    return bytesAvailable();
+}
+
+bool ServerResponse::atEnd() const
+{
+    RESTLINK_D(const ServerResponse);
+    QReadLocker locker(&d->lock);
+    return (d->streamed ? d->finished && d->stream.isEmpty() : d->atEnd);
+}
+
+qint64 ServerResponse::bytesAvailable() const
+{
+    RESTLINK_D(const ServerResponse);
+    QReadLocker locker(&d->lock);
+    return d->stream.size() + QIODevice::bytesAvailable();
+}
+
+bool ServerResponse::canReadLine() const
+{
+    RESTLINK_D(const ServerResponse);
+    QReadLocker locker(&d->lock);
+    return d->stream.contains('\n') || QIODevice::canReadLine();
+}
+
 QNetworkRequest ServerResponse::networkRequest() const
 {
     RESTLINK_D(const ServerResponse);
@@ -182,6 +312,11 @@ void ServerResponse::complete()
 {
     RESTLINK_D(ServerResponse);
     d->lock.lockForWrite();
+    if (d->finished) {
+        // Already aborted or timed out
+        d->lock.unlock();
+        return;
+    }
     d->finished = true;
     d->lock.unlock();
 
@@ -193,16 +328,54 @@ void ServerResponse::ignoreSslErrors()
     // No-Op
 }
 
+/*!
+ * \brief Aborts the response.
+ *
+ * The response finishes right away with an operation canceled network error, whatever the
+ * worker writes afterwards is discarded. Workers may check isAborted() to stop processing.
+ */
 void ServerResponse::abort()
 {
-    // No-Op
+    RESTLINK_D(ServerResponse);
+
+    {
+        QWriteLocker locker(&d->lock);
+        if (d->finished)
+            return;
+
+        d->aborted = true;
+        d->networkError = QNetworkReply::OperationCanceledError;
+        d->streamConsumed.wakeAll();
+    }
+
+    emit networkErrorOccured(QNetworkReply::OperationCanceledError);
+    complete();
+}
+
+qint64 ServerResponse::readData(char *data, qint64 maxlen)
+{
+    RESTLINK_D(ServerResponse);
+    QWriteLocker locker(&d->lock);
+    return d->readStream(data, maxlen, false);
+}
+
+qint64 ServerResponse::readLineData(char *data, qint64 maxlen)
+{
+    RESTLINK_D(ServerResponse);
+    QWriteLocker locker(&d->lock);
+    return d->readStream(data, maxlen, true);
 }
 
 ServerResponsePrivate::ServerResponsePrivate(ServerResponse *q)
     : ResponsePrivate(q)
     , method(AbstractRequestHandler::UnknownMethod)
+    , streamed(false)
+    , streamRead(false)
     , httpStatusCode(200)
     , finished(false)
+    , aborted(false)
+    , networkError(QNetworkReply::NoError)
+    , deferred(false)
     , atEnd(false)
     , server(nullptr)
 {
@@ -212,8 +385,41 @@ ServerResponsePrivate::~ServerResponsePrivate()
 {
 }
 
+bool ServerResponsePrivate::hasJsonBody() const
+{
+    return body.hasJsonObject() || body.hasJsonArray() || body.contentType() == RESTLINK_MIME_JSON;
+}
+
+QJsonValue ServerResponsePrivate::readJson(QJsonParseError *error)
+{
+    if (body.hasJsonObject())
+        return readBody().jsonObject();
+
+    if (body.hasJsonArray())
+        return readBody().jsonArray();
+
+    // Bodies may also carry already serialized JSON bytes
+    if (body.contentType() == RESTLINK_MIME_JSON) {
+        const QJsonDocument doc = QJsonDocument::fromJson(readBody().toByteArray(), error);
+        if (doc.isObject())
+            return doc.object();
+        else if (doc.isArray())
+            return doc.array();
+    }
+
+    return QJsonValue();
+}
+
 Body ServerResponsePrivate::readBody()
 {
+    // Streamed bodies give what was written since the last read
+    if (streamed) {
+        streamRead = true;
+        const QByteArray data = std::exchange(stream, QByteArray());
+        streamConsumed.wakeAll();
+        return Body(data, body.contentType().toUtf8());
+    }
+
     if (atEnd) {
         return Body();
     } else {
@@ -222,4 +428,23 @@ Body ServerResponsePrivate::readBody()
     }
 }
 
+qint64 ServerResponsePrivate::readStream(char *data, qint64 maxlen, bool line)
+{
+    qint64 size = qMin<qint64>(maxlen, stream.size());
+    if (line) {
+        const qsizetype end = stream.indexOf('\n');
+        if (end >= 0)
+            size = qMin<qint64>(size, end + 1);
+    }
+
+    if (size > 0) {
+        memcpy(data, stream.constData(), size);
+        stream.remove(0, size);
+    }
+
+    streamRead = true;
+    streamConsumed.wakeAll();
+    return size;
+}
+
 } // namespace RestLink
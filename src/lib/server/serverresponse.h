@@ -20,6 +20,10 @@ public:
     void setMethod(AbstractRequestHandler::Method method);
 
     bool isFinished() const override;
+    bool isAborted() const;
+
+    void defer();
+    bool isDeferred() const;
 
     int httpStatusCode() const override;
     void setHttpStatusCode(int code);
@@ -29,12 +33,24 @@ public:
     QStringList headerList() const override;
     void setHeaders(const QList<Header> &headers);
 
+    int networkError() const override;
+
     QJsonObject readJsonObject(QJsonParseError *error) override;
     QJsonArray readJsonArray(QJsonParseError *error) override;
     QJsonValue readJson(QJsonParseError *error) override;
     QString readString() override;
     QByteArray readBody() override;
     void setBody(const Body &body);
+    bool writeBody(const QByteArray &data);
+
+    bool isStreamed() const;
+
+    bool isSequential() const override;
+    qint64 pos() const override;
+    qint64 size() const override;
+    bool atEnd() const override;
+    qint64 bytesAvailable() const override;
+    bool canReadLine() const override;
 
     QNetworkRequest networkRequest() const override;
     void setNetworkRequest(const QNetworkRequest &request);
@@ -50,6 +66,10 @@ public slots:
 
     void ignoreSslErrors() override;
     void abort() override;
+
+protected:
+    qint64 readData(char *data, qint64 maxlen) override;
+    qint64 readLineData(char *data, qint64 maxlen) override;
 };
 
 } // namespace RestLink
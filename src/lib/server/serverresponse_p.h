@@ -7,8 +7,10 @@
 #include <RestLink/body.h>
 #include <RestLink/private/response_p.h>
 
+#include <QtCore/qjsondocument.h>
 #include <QtCore/qjsonvalue.h>
 #include <QtCore/qreadwritelock.h>
+#include <QtCore/qwaitcondition.h>
 
 #include <QtNetwork/qnetworkrequest.h>
 
@@ -20,15 +22,26 @@ public:
     ServerResponsePrivate(ServerResponse *q);
     ~ServerResponsePrivate();
 
+    bool hasJsonBody() const;
+    QJsonValue readJson(QJsonParseError *error);
     Body readBody();
+    qint64 readStream(char *data, qint64 maxlen, bool line);
 
     AbstractRequestHandler::Method method;
     Body body;
 
+    QByteArray stream;
+    bool streamed;
+    bool streamRead;
+    QWaitCondition streamConsumed;
+
     int httpStatusCode;
     HeaderList headers;
 
     bool finished;
+    bool aborted;
+    int networkError;
+    bool deferred;
     bool atEnd;
 
     QNetworkRequest networkRequest;
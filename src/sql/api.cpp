@@ -1,17 +1,28 @@
 #include "api.h"
+#include "connectionpool.h"
 
 #include <meta/endpointinfo.h>
 #include <meta/resourceinfo.h>
 
+#include <utils/schemacache.h>
+#include <utils/resultcache.h>
+#include <utils/latencystats.h>
+
+#include <debug.h>
+
 #include <RestLink/debug.h>
 
 #include <QtCore/qjsonarray.h>
 #include <QtCore/qjsonvalue.h>
+#include <QtCore/qthread.h>
 
 #include <QtSql/qsqlindex.h>
 #include <QtSql/qsqlrecord.h>
 #include <QtSql/qsqlfield.h>
 
+#define DEFAULT_REPLICA_STICKINESS 5
+#define DEFAULT_SLOW_QUERY_THRESHOLD 1000
+
 namespace RestLink {
 namespace Sql {
 
@@ -19,26 +30,26 @@ Api::Api(const QUrl &url)
     : m_url(url)
     , m_connectionClosable(true)
     , m_autoConfigured(true)
+    , m_slowQueryThreshold(DEFAULT_SLOW_QUERY_THRESHOLD)
+    , m_queryTimeout(0)
+    , m_replicaSelection(RoundRobin)
+    , m_replicaStickiness(DEFAULT_REPLICA_STICKINESS)
+    , m_nextReplica(0)
+    , m_replicaCount(0)
     , m_activeModels(0)
 {
     static unsigned int connectionId = 0;
 
-    const QString driverName = 'Q' + url.scheme().toUpper();
     m_dbConnectionName = QStringLiteral("RestLink_%1").arg(connectionId++);
+    addDatabase(url, m_dbConnectionName);
 
-    QSqlDatabase db = QSqlDatabase::addDatabase(driverName, m_dbConnectionName);
-    db.setHostName(url.host());
-    db.setPort(url.port());
-    db.setUserName(url.userName());
-    db.setPassword(url.password());
+    m_pool.reset(new ConnectionPool(m_dbConnectionName));
+    if (url.scheme() == "sqlite" && url.path().startsWith("memory"))
+        m_pool->setMaximumSize(1); // Each connection would see its own in-memory database
 
-    if (url.scheme() == "sqlite") {
-        if (url.path().startsWith("memory"))
-            db.setDatabaseName(":memory:");
-        else
-            db.setDatabaseName(url.path());
-    } else
-        db.setDatabaseName(url.path().mid(1));
+    m_schema = SchemaCache::cache(url);
+    m_resultCache.reset(new ResultCache());
+    m_latencyStats.reset(new LatencyStats());
 
     reset();
 
@@ -47,6 +58,9 @@ Api::Api(const QUrl &url)
 
 Api::~Api()
 {
+    m_schema->save();
+    loadReplicas(QJsonObject());
+    m_pool.reset();
     if (!s_shutingDown && QSqlDatabase::contains(m_dbConnectionName))
         QSqlDatabase::removeDatabase(m_dbConnectionName);
     s_apis.remove(m_url);
@@ -69,7 +83,8 @@ void Api::setConnectionClosable(bool closeable)
 
 bool Api::isConfigured() const
 {
-    return !m_resources.isEmpty();
+    QMutexLocker locker(&m_mutex);
+    return !m_resources.isEmpty() || !m_tables.isEmpty();
 }
 
 bool Api::isAutoConfigured() const
@@ -81,6 +96,10 @@ QJsonObject Api::configuration() const
 {
     QJsonObject configuration;
 
+    loadTables();
+
+    QMutexLocker locker(&m_mutex);
+
     QJsonObject endpoints;
     for (const EndpointInfo &info : m_endpoints) {
         QJsonObject endpoint;
@@ -97,18 +116,47 @@ QJsonObject Api::configuration() const
     }
     configuration.insert("resources", resources);
 
+    QJsonObject pool;
+    m_pool->save(&pool);
+    configuration.insert("pool", pool);
+
+    if (!m_schemaVersion.isEmpty())
+        configuration.insert("schema_version", m_schemaVersion);
+
+    if (!m_replicas.isEmpty()) {
+        QJsonObject replicas;
+        saveReplicas(&replicas);
+        configuration.insert("replicas", replicas);
+    }
+
+    QJsonObject execution;
+    execution.insert("slow_threshold", m_slowQueryThreshold);
+    execution.insert("timeout", m_queryTimeout);
+    configuration.insert("execution", execution);
+
     return configuration;
 }
 
 void Api::configure(const QJsonObject &configuration, const QHash<QString, QString> &options)
 {
+    QMutexLocker locker(&m_mutex);
+
     m_endpoints.clear();
     m_resources.clear();
+    m_resourceTables.clear();
+    m_tables.clear();
+    m_resultCache->clear();
+
+    if (configuration.contains("pool")) {
+        m_pool->load(configuration.value("pool").toObject());
+        if (m_url.scheme() == "sqlite" && m_url.path().startsWith("memory"))
+            m_pool->setMaximumSize(1);
+    }
 
     if (!options.isEmpty()) {
+        m_pool->clear();
+
         QSqlDatabase db = QSqlDatabase::database(m_dbConnectionName, false);
-        if (db.isOpen())
-            db.close();
 
         if (options.contains("DATABASE_NAME"))
             db.setDatabaseName(options.value("DATABASE_NAME"));
@@ -117,6 +165,18 @@ void Api::configure(const QJsonObject &configuration, const QHash<QString, QStri
             db.setConnectOptions(options.value("CONNECT_OPTIONS"));
     }
 
+    loadReplicas(configuration.value("replicas").toObject());
+
+    // Requests slower than the threshold on average run outside of the router thread
+    const QJsonObject execution = configuration.value("execution").toObject();
+    m_slowQueryThreshold = execution.value("slow_threshold").toInt(DEFAULT_SLOW_QUERY_THRESHOLD);
+    m_queryTimeout = execution.value("timeout").toInt();
+    m_latencyStats->clear();
+
+    // A declared version saves us from asking the database about its schema
+    m_schemaVersion = configuration.value("schema_version").toString();
+    m_schema->refresh(this, m_schemaVersion);
+
     // Loading resources
     const QJsonObject resources = configuration.value("resources").toObject();
     const QStringList resourceNames = resources.keys();
@@ -126,6 +186,7 @@ void Api::configure(const QJsonObject &configuration, const QHash<QString, QStri
 
         if (resource.isValid()) {
             m_resources.insert(resourceName, resource);
+            m_resourceTables.insert(resource.table(), resourceName);
 
             const EndpointInfo endpoint = EndpointInfo::fromResource(resource);
             m_endpoints.insert(endpoint.name(), endpoint);
@@ -141,6 +202,8 @@ void Api::configure(const QJsonObject &configuration, const QHash<QString, QStri
         m_endpoints.insert(endpointName, endpoint);
     }
 
+    m_schema->save();
+
     resetIdleTime();
 
     m_autoConfigured = false;
@@ -148,23 +211,27 @@ void Api::configure(const QJsonObject &configuration, const QHash<QString, QStri
 
 void Api::reset()
 {
+    QMutexLocker locker(&m_mutex);
+
     m_endpoints.clear();
     m_resources.clear();
+    m_resourceTables.clear();
+    m_tables.clear();
+    m_resultCache->clear();
+    m_latencyStats->clear();
 
-    QSqlDatabase db = database();
+    m_slowQueryThreshold = DEFAULT_SLOW_QUERY_THRESHOLD;
+    m_queryTimeout = 0;
 
-    const QStringList tables = db.tables();
-    for (const QString &tableName : tables) {
-        QJsonObject object;
-        object.insert("table", tableName);
+    m_schemaVersion.clear();
+    m_schema->refresh(this);
 
-        EndpointInfo endpoint;
-        endpoint.load('/' + tableName.toLower(), object, this);
-        m_endpoints.insert(endpoint.name(), endpoint);
+    // Resources are only introspected when first requested
+    const QStringList tables = m_schema->tables(this);
+    for (const QString &tableName : tables)
+        m_tables.insert(tableName.toLower(), tableName);
 
-        if (endpoint.hasResource())
-            m_resources.insert(endpoint.name(), endpoint.resource());
-    }
+    m_schema->save();
 
     resetIdleTime();
 
@@ -173,32 +240,40 @@ void Api::reset()
 
 EndpointInfo Api::endpointInfo(const QString &name) const
 {
+    QMutexLocker locker(&m_mutex);
+    if (name.startsWith('/'))
+        loadTable(name.mid(1));
     return m_endpoints.value(name);
 }
 
 ResourceInfo Api::resourceInfo(const QString &name) const
 {
+    QMutexLocker locker(&m_mutex);
+    loadTable(name);
     return m_resources.value(name);
 }
 
 ResourceInfo Api::resourceInfoByTable(const QString &table) const
 {
-    auto it = std::find_if(m_resources.begin(), m_resources.end(), [&table](const ResourceInfo &info) {
-        return info.table() == table;
-    });
+    QMutexLocker locker(&m_mutex);
+    loadTable(table.toLower());
 
-    return (it != m_resources.end() ? *it : ResourceInfo());
+    const auto it = m_resourceTables.constFind(table);
+    return (it != m_resourceTables.constEnd() ? m_resources.value(*it) : ResourceInfo());
 }
 
 QStringList Api::resourceNames() const
 {
+    loadTables();
+
+    QMutexLocker locker(&m_mutex);
     return m_resources.keys();
 }
 
 qint64 Api::idleTime() const
 {
     const QDateTime now = QDateTime::currentDateTime();
-    return now.secsTo(m_lastUsedTime);
+    return m_lastUsedTime.secsTo(now);
 }
 
 void Api::resetIdleTime()
@@ -208,26 +283,107 @@ void Api::resetIdleTime()
 
 void Api::closeDatabase()
 {
-    QSqlDatabase db = QSqlDatabase::database(m_dbConnectionName, false);
-    if (db.isOpen())
-        db.close();
+    m_pool->evictIdleConnections(true);
+
+    QMutexLocker locker(&m_replicaMutex);
+    for (const Replica &replica : std::as_const(m_replicas))
+        replica.pool->evictIdleConnections(true);
 }
 
 QSqlDatabase Api::database() const
 {
-    return QSqlDatabase::database(m_dbConnectionName, true);
+    return boundPool()->database();
 }
 
-bool Api::hasApi(const QUrl &url)
+QSqlDatabase Api::acquireDatabase(Access access, const QString &client)
 {
-    if (!url.isValid())
-        return false;
+    return selectPool(access, client)->acquire();
+}
 
-    auto it = std::find_if(s_apis.begin(), s_apis.end(), [&url](const Api *manager) {
-        return manager->m_url == url;
-    });
+void Api::releaseDatabase()
+{
+    QMutexLocker locker(&m_replicaMutex);
+
+    auto it = m_bindings.find(QThread::currentThread());
+    if (it == m_bindings.end()) {
+        locker.unlock();
+        m_pool->release();
+        return;
+    }
+
+    ConnectionPool *pool = it->pool;
+    const QSharedPointer<ConnectionPool> replica = it->replica;
+    if (--it->refs == 0) {
+        // Reads that follow a client's write stay on the primary for a while
+        if (it->write && m_replicaStickiness > 0 && !m_replicas.isEmpty()) {
+            const qint64 now = QDateTime::currentMSecsSinceEpoch();
+            m_lastWrites.removeIf([this, now](const QHash<QString, qint64>::iterator &write) {
+                return now - write.value() >= m_replicaStickiness * 1000;
+            });
+            m_lastWrites.insert(it->client, now);
+        }
+        m_bindings.erase(it);
+    }
+
+    locker.unlock();
+    pool->release();
+}
+
+ConnectionPool *Api::connectionPool() const
+{
+    return m_pool.get();
+}
+
+SchemaCache *Api::schema() const
+{
+    return m_schema;
+}
+
+ResultCache *Api::resultCache() const
+{
+    return m_resultCache.get();
+}
+
+int Api::slowQueryThreshold() const
+{
+    return m_slowQueryThreshold;
+}
+
+int Api::queryTimeout() const
+{
+    return m_queryTimeout;
+}
+
+LatencyStats *Api::latencyStats() const
+{
+    return m_latencyStats.get();
+}
+
+QList<QUrl> Api::replicaUrls() const
+{
+    QMutexLocker locker(&m_replicaMutex);
+
+    QList<QUrl> urls;
+    for (const Replica &replica : m_replicas)
+        urls.append(replica.url);
+    return urls;
+}
+
+Api::ReplicaSelection Api::replicaSelection() const
+{
+    QMutexLocker locker(&m_replicaMutex);
+    return m_replicaSelection;
+}
 
-    return (it != s_apis.end());
+int Api::replicaStickiness() const
+{
+    QMutexLocker locker(&m_replicaMutex);
+    return m_replicaStickiness;
+}
+
+bool Api::hasApi(const QUrl &url)
+{
+    return url.isValid() && s_apis.contains(url);
 }
 
 Api *Api::api(const QUrl &url)
@@ -235,14 +391,8 @@ Api *Api::api(const QUrl &url)
     if (!url.isValid())
         return nullptr;
 
-    auto it = std::find_if(s_apis.begin(), s_apis.end(), [&url](const Api *manager) {
-        return manager->m_url == url;
-    });
-
-    if (it != s_apis.end())
-        return *it;
-
-    return new Api(url);
+    Api *api = s_apis.value(url);
+    return (api ? api : new Api(url));
 }
 
 int Api::apiCount()
@@ -257,24 +407,30 @@ void Api::purgeApis(int atLeast, bool remove)
     else if (atLeast > s_apis.size())
         atLeast = s_apis.size();
 
-    int closed = 0;
-    auto closeConnections = [&closed, &remove](const QList<Api *> apis, bool force) {
+    // When removing, only removed APIs count toward the target, evictions alone don't
+    int removed = 0;
+    int drained = 0;
+    auto closeConnections = [&removed, &drained, &remove](const QList<Api *> apis, bool force) {
         for (Api *api : apis) {
-            // We close database connections which were unused during at least 30 minutes
-            if (force || api->idleTime() > 1800) {
-                closed++;
-                if (remove)
-                    delete api;
-                else if (api->canCloseConnection())
-                    api->closeDatabase();
-                else
-                    closed--;
+            // Unused APIs can be removed, others give back connections idle for too long
+            if (remove && (force || api->idleTime() > api->m_pool->maximumIdleTime())) {
+                delete api;
+                removed++;
+            } else if (api->canCloseConnection()) {
+                int evicted = api->m_pool->evictIdleConnections(force);
+
+                QMutexLocker locker(&api->m_replicaMutex);
+                for (const Replica &replica : std::as_const(api->m_replicas))
+                    evicted += replica.pool->evictIdleConnections(force);
+
+                if (evicted > 0)
+                    drained++;
             }
         }
     };
 
     closeConnections(s_apis.values(), false);
-    if (closed >= atLeast)
+    if ((remove ? removed : drained) >= atLeast)
         return;
 
     QList<Api *> apis = s_apis.values();
@@ -294,6 +450,166 @@ void Api::cleanupApis()
     const QList<QUrl> urls = s_apis.keys();
     for (const QUrl &url : urls)
         delete s_apis.take(url);
+
+    SchemaCache::cleanupCaches();
+}
+
+void Api::loadTable(const QString &name) const
+{
+    const QString table = m_tables.take(name);
+    if (table.isEmpty())
+        return;
+
+    QJsonObject object;
+    object.insert("table", table);
+
+    ResourceInfo resource;
+    resource.load(name, object, const_cast<Api *>(this));
+
+    if (resource.isValid()) {
+        m_resources.insert(name, resource);
+        m_resourceTables.insert(resource.table(), name);
+
+        const EndpointInfo endpoint = EndpointInfo::fromResource(resource);
+        m_endpoints.insert(endpoint.name(), endpoint);
+    }
+}
+
+void Api::loadTables() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    const QStringList names = m_tables.keys();
+    for (const QString &name : names)
+        loadTable(name);
+}
+
+void Api::loadReplicas(const QJsonObject &object)
+{
+    QMutexLocker locker(&m_replicaMutex);
+
+    // Replicas given without password, as saved, keep the one they were configured with
+    QHash<QString, QUrl> knownUrls;
+    for (const Replica &replica : std::as_const(m_replicas))
+        knownUrls.insert(replica.url.toString(QUrl::RemovePassword), replica.url);
+
+    // Pools still bound to a thread are destroyed once released
+    m_replicas.clear();
+    m_lastWrites.clear();
+
+    m_replicaSelection = (object.value("selection").toString() == "least_loaded" ? LeastLoaded : RoundRobin);
+    m_replicaStickiness = object.value("stickiness").toInt(DEFAULT_REPLICA_STICKINESS);
+
+    QJsonObject poolObject;
+    m_pool->save(&poolObject);
+
+    const QJsonArray urls = object.value("urls").toArray();
+    for (const QJsonValue &value : urls) {
+        QUrl url(value.toString());
+        if (url.password().isEmpty())
+            url = knownUrls.value(url.toString(QUrl::RemovePassword), url);
+
+        if (!url.isValid() || url.scheme() != m_url.scheme()) {
+            sqlWarning() << "Ignoring invalid replica " << url.toString(QUrl::RemovePassword);
+            continue;
+        }
+
+        Replica replica;
+        replica.url = url;
+        replica.connectionName = m_dbConnectionName + QStringLiteral("_replica_") + QString::number(m_replicaCount++);
+        addDatabase(url, replica.connectionName);
+
+        const QString connectionName = replica.connectionName;
+        replica.pool.reset(new ConnectionPool(connectionName), [connectionName](ConnectionPool *pool) {
+            delete pool;
+            if (!s_shutingDown && QSqlDatabase::contains(connectionName))
+                QSqlDatabase::removeDatabase(connectionName);
+        });
+        replica.pool->load(poolObject);
+        m_replicas.append(replica);
+    }
+}
+
+void Api::saveReplicas(QJsonObject *object) const
+{
+    QMutexLocker locker(&m_replicaMutex);
+
+    // Credentials are not exposed, loadReplicas() restores those of the replicas it already knows
+    QJsonArray urls;
+    for (const Replica &replica : m_replicas)
+        urls.append(replica.url.toString(QUrl::RemovePassword));
+
+    object->insert("urls", urls);
+    object->insert("selection", m_replicaSelection == LeastLoaded ? "least_loaded" : "round_robin");
+    object->insert("stickiness", m_replicaStickiness);
+}
+
+ConnectionPool *Api::boundPool() const
+{
+    QMutexLocker locker(&m_replicaMutex);
+    ConnectionPool *pool = m_bindings.value(QThread::currentThread()).pool;
+    return (pool ? pool : m_pool.get());
+}
+
+ConnectionPool *Api::selectPool(Access access, const QString &client)
+{
+    QMutexLocker locker(&m_replicaMutex);
+
+    // Nested acquisitions keep the connection of the outermost one
+    Binding &binding = m_bindings[QThread::currentThread()];
+    if (binding.refs++ > 0) {
+        if (access == ReadWrite && binding.pool != m_pool.get())
+            sqlWarning() << "Write access requested while reading from a replica";
+        binding.write = binding.write || access == ReadWrite;
+        return binding.pool;
+    }
+
+    binding.write = (access == ReadWrite);
+    binding.pool = m_pool.get();
+    binding.client = client;
+
+    // Clients read their own writes, others may still be served by replicas
+    const auto lastWrite = m_lastWrites.constFind(client);
+    const bool sticky = (lastWrite != m_lastWrites.cend()
+                         && QDateTime::currentMSecsSinceEpoch() - *lastWrite < m_replicaStickiness * 1000);
+    if (access == ReadWrite || sticky || m_replicas.isEmpty())
+        return binding.pool;
+
+    if (m_replicaSelection == LeastLoaded) {
+        int lowestLoad = -1;
+        for (const Replica &replica : std::as_const(m_replicas)) {
+            const int load = replica.pool->size() - replica.pool->idleCount();
+            if (lowestLoad < 0 || load < lowestLoad) {
+                lowestLoad = load;
+                binding.replica = replica.pool;
+            }
+        }
+    } else {
+        binding.replica = m_replicas.at(m_nextReplica++ % m_replicas.size()).pool;
+    }
+
+    binding.pool = binding.replica.get();
+
+    return binding.pool;
+}
+
+void Api::addDatabase(const QUrl &url, const QString &connectionName)
+{
+    const QString driverName = 'Q' + url.scheme().toUpper();
+
+    QSqlDatabase db = QSqlDatabase::addDatabase(driverName, connectionName);
+    db.setHostName(url.host());
+    db.setPort(url.port());
+    db.setUserName(url.userName());
+    db.setPassword(url.password());
+
+    if (url.scheme() == "sqlite") {
+        if (url.path().startsWith("memory"))
+            db.setDatabaseName(":memory:");
+        else
+            db.setDatabaseName(url.path());
+    } else
+        db.setDatabaseName(url.path().mid(1));
 }
 
 void Api::refModel(const Model *model)
@@ -6,19 +6,38 @@
 #include <QtCore/qurl.h>
 #include <QtCore/qjsonobject.h>
 #include <QtCore/qatomic.h>
+#include <QtCore/qscopedpointer.h>
+#include <QtCore/qsharedpointer.h>
+#include <QtCore/qmutex.h>
 
 #include <QtSql/qsqldatabase.h>
 
+class QThread;
+
 namespace RestLink {
 namespace Sql {
 
 class EndpointInfo;
 class ResourceInfo;
 class Model;
+class ConnectionPool;
+class SchemaCache;
+class ResultCache;
+class LatencyStats;
 
 class SQL_EXPORT Api final
 {
 public:
+    enum Access {
+        ReadWrite,
+        ReadOnly
+    };
+
+    enum ReplicaSelection {
+        RoundRobin,
+        LeastLoaded
+    };
+
     ~Api();
 
     QUrl url() const;
@@ -42,6 +61,19 @@ public:
 
     void closeDatabase();
     QSqlDatabase database() const;
+    QSqlDatabase acquireDatabase(Access access = ReadWrite, const QString &client = QString());
+    void releaseDatabase();
+    ConnectionPool *connectionPool() const;
+
+    QList<QUrl> replicaUrls() const;
+    ReplicaSelection replicaSelection() const;
+    int replicaStickiness() const;
+    SchemaCache *schema() const;
+    ResultCache *resultCache() const;
+
+    int slowQueryThreshold() const;
+    int queryTimeout() const;
+    LatencyStats *latencyStats() const;
 
     static bool hasApi(const QUrl &url);
     static Api *api(const QUrl &url);
@@ -56,14 +88,57 @@ protected:
 private:
     Api(const QUrl &url);
 
+    void loadTable(const QString &name) const;
+    void loadTables() const;
+
+    void loadReplicas(const QJsonObject &object);
+    void saveReplicas(QJsonObject *object) const;
+    ConnectionPool *boundPool() const;
+    ConnectionPool *selectPool(Access access, const QString &client);
+
+    static void addDatabase(const QUrl &url, const QString &connectionName);
+
     const QUrl m_url;
     bool m_connectionClosable;
 
-    QHash<QString, EndpointInfo> m_endpoints;
-    QHash<QString, ResourceInfo> m_resources;
+    mutable QHash<QString, EndpointInfo> m_endpoints;
+    mutable QHash<QString, ResourceInfo> m_resources;
+    mutable QHash<QString, QString> m_resourceTables; // Table to resource name
+    mutable QHash<QString, QString> m_tables; // Found by introspection, loaded on first use
+    mutable QRecursiveMutex m_mutex;
     bool m_autoConfigured;
     QDateTime m_lastUsedTime;
     QString m_dbConnectionName;
+    QScopedPointer<ConnectionPool> m_pool;
+    QScopedPointer<ResultCache> m_resultCache;
+    QScopedPointer<LatencyStats> m_latencyStats;
+    int m_slowQueryThreshold; // Milliseconds
+    int m_queryTimeout; // Milliseconds
+
+    struct Replica {
+        QUrl url;
+        QString connectionName;
+        QSharedPointer<ConnectionPool> pool;
+    };
+
+    struct Binding {
+        ConnectionPool *pool = nullptr;
+        QSharedPointer<ConnectionPool> replica; // Keeps a reconfigured replica alive until released
+        QString client;
+        int refs = 0;
+        bool write = false;
+    };
+
+    QList<Replica> m_replicas;
+    ReplicaSelection m_replicaSelection;
+    int m_replicaStickiness;
+    int m_nextReplica;
+    int m_replicaCount; // Replicas ever created, names stay unique across reconfigurations
+    QHash<QString, qint64> m_lastWrites; // Last write time of each client
+    QHash<QThread *, Binding> m_bindings; // Pool used by each thread's current request
+    mutable QMutex m_replicaMutex;
+    SchemaCache *m_schema;
+    QString m_schemaVersion;
 
     QAtomicInt m_activeModels;
 
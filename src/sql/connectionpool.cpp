@@ -0,0 +1,372 @@
+#include "connectionpool.h"
+
+#include <debug.h>
+
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qdeadlinetimer.h>
+
+#include <QtSql/qsqlquery.h>
+
+#define DEFAULT_MINIMUM_SIZE          1
+#define DEFAULT_MAXIMUM_SIZE          8
+#define DEFAULT_MAXIMUM_IDLE_TIME     1800
+#define DEFAULT_HEALTH_CHECK_INTERVAL 60
+
+namespace RestLink {
+namespace Sql {
+
+ConnectionPool::ConnectionPool(const QString &connectionName)
+    : m_templateName(connectionName)
+    , m_minimumSize(DEFAULT_MINIMUM_SIZE)
+    , m_maximumSize(DEFAULT_MAXIMUM_SIZE)
+    , m_maximumIdleTime(DEFAULT_MAXIMUM_IDLE_TIME)
+    , m_healthCheckInterval(DEFAULT_HEALTH_CHECK_INTERVAL)
+    , m_waiters(0)
+    , m_nextId(0)
+{
+    // The template connection belongs to the thread which registered it, it is used as-is there
+    Connection connection;
+    connection.name = connectionName;
+    connection.thread = QThread::currentThread();
+    connection.releaseTime = QDateTime::currentMSecsSinceEpoch();
+    connection.checkTime = connection.releaseTime;
+    m_connections.append(connection);
+}
+
+ConnectionPool::~ConnectionPool()
+{
+    QMutexLocker locker(&m_mutex);
+
+    // Removing the template connection is left to its owner
+    for (qsizetype i = m_connections.size() - 1; i >= 0; --i)
+        if (m_connections.at(i).name != m_templateName)
+            removeConnection(i);
+}
+
+int ConnectionPool::minimumSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_minimumSize;
+}
+
+void ConnectionPool::setMinimumSize(int size)
+{
+    QMutexLocker locker(&m_mutex);
+    m_minimumSize = qMax(0, size);
+}
+
+int ConnectionPool::maximumSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maximumSize;
+}
+
+void ConnectionPool::setMaximumSize(int size)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maximumSize = qMax(1, size);
+}
+
+int ConnectionPool::maximumIdleTime() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maximumIdleTime;
+}
+
+void ConnectionPool::setMaximumIdleTime(int secs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maximumIdleTime = secs;
+}
+
+int ConnectionPool::healthCheckInterval() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_healthCheckInterval;
+}
+
+void ConnectionPool::setHealthCheckInterval(int secs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_healthCheckInterval = secs;
+}
+
+int ConnectionPool::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_connections.size();
+}
+
+int ConnectionPool::idleCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return std::count_if(m_connections.begin(), m_connections.end(), [](const Connection &connection) {
+        return connection.refs == 0;
+    });
+}
+
+QSqlDatabase ConnectionPool::database()
+{
+    QString name;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        const int index = findConnection(QThread::currentThread(), false);
+        if (index >= 0 && !m_connections.at(index).stale) {
+            Connection &connection = m_connections[index];
+            if (connection.refs == 0)
+                connection.releaseTime = QDateTime::currentMSecsSinceEpoch();
+            name = connection.name;
+        }
+    }
+
+    if (!name.isEmpty())
+        return QSqlDatabase::database(name, true);
+
+    // The calling thread has no connection yet, it gets one which stays idle in the pool
+    const QSqlDatabase db = acquire();
+    if (!db.isValid())
+        return db;
+
+    // Unlike release(), the connection is kept even if other threads are waiting for a slot
+    QMutexLocker locker(&m_mutex);
+    const int index = findConnection(QThread::currentThread(), false);
+    if (index >= 0 && m_connections.at(index).refs > 0) {
+        Connection &connection = m_connections[index];
+        if (--connection.refs == 0)
+            connection.releaseTime = QDateTime::currentMSecsSinceEpoch();
+    }
+    return db;
+}
+
+QSqlDatabase ConnectionPool::acquire(int timeout)
+{
+    QThread *thread = QThread::currentThread();
+    const QDeadlineTimer deadline(timeout);
+
+    QMutexLocker locker(&m_mutex);
+
+    int index = findConnection(thread, false);
+    // Stale connections were cloned before a reconfiguration, we replace them unless they are in use
+    while (index < 0 || (m_connections.at(index).stale && m_connections.at(index).refs == 0)) {
+        if (index >= 0) {
+            removeConnection(index);
+            index = findConnection(thread, false);
+            continue;
+        }
+
+        if (m_connections.size() < m_maximumSize) {
+            index = createConnection();
+            break;
+        }
+
+        // Connections of finished threads can't be used anymore
+        const qsizetype size = m_connections.size();
+        m_connections.removeIf([this](const Connection &connection) {
+            if (connection.thread || connection.name == m_templateName)
+                return false;
+            QSqlDatabase::removeDatabase(connection.name);
+            return true;
+        });
+
+        if (m_connections.size() < size) {
+            index = findConnection(thread, false);
+            continue;
+        }
+
+        ++m_waiters;
+        const bool released = m_released.wait(&m_mutex, deadline);
+        --m_waiters;
+
+        if (!released) {
+            sqlWarning() << "No database connection available on " << m_templateName << " after " << timeout << "ms";
+            return QSqlDatabase();
+        }
+
+        index = findConnection(thread, false);
+    }
+
+    Connection &connection = m_connections[index];
+    connection.refs++;
+
+    // Connections that were idle for a while get checked before being handed out
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const bool check = (connection.refs == 1 && now - connection.checkTime > m_healthCheckInterval * 1000);
+    if (check)
+        connection.checkTime = now;
+
+    const QString name = connection.name;
+    locker.unlock();
+
+    if (check && !checkConnection(name))
+        sqlWarning() << "Database connection " << name << " failed its health check";
+
+    return QSqlDatabase::database(name, true);
+}
+
+void ConnectionPool::release()
+{
+    QMutexLocker locker(&m_mutex);
+
+    const int index = findConnection(QThread::currentThread(), false);
+    if (index < 0 || m_connections.at(index).refs == 0)
+        return;
+
+    Connection &connection = m_connections[index];
+    if (--connection.refs > 0)
+        return;
+
+    connection.releaseTime = QDateTime::currentMSecsSinceEpoch();
+
+    // Another thread is waiting for a slot, we give ours back
+    if (m_waiters > 0 && m_connections.size() >= m_maximumSize && connection.name != m_templateName)
+        removeConnection(index);
+
+    m_released.wakeAll();
+}
+
+int ConnectionPool::evictIdleConnections(bool force)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QThread *thread = QThread::currentThread();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    int evicted = 0;
+    for (qsizetype i = m_connections.size() - 1; i >= 0; --i) {
+        const Connection &connection = m_connections.at(i);
+
+        // Connections can only be closed by their own thread, unless it is gone
+        if (connection.thread && connection.thread != thread)
+            continue;
+
+        if (connection.refs > 0)
+            continue;
+
+        if (!force && !connection.stale && now - connection.releaseTime < m_maximumIdleTime * 1000)
+            continue;
+
+        // Removed connections have already left the list, the template never does
+        if (!force && !connection.stale && m_connections.size() <= m_minimumSize)
+            continue;
+
+        if (removeConnection(i))
+            ++evicted;
+    }
+
+    if (evicted > 0)
+        m_released.wakeAll();
+
+    return evicted;
+}
+
+void ConnectionPool::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    QThread *thread = QThread::currentThread();
+    for (qsizetype i = m_connections.size() - 1; i >= 0; --i) {
+        Connection &connection = m_connections[i];
+        if (connection.thread == thread && connection.refs == 0)
+            removeConnection(i);
+        else if (connection.name != m_templateName)
+            connection.stale = true;
+    }
+
+    m_released.wakeAll();
+}
+
+void ConnectionPool::load(const QJsonObject &object)
+{
+    QMutexLocker locker(&m_mutex);
+    m_minimumSize = qMax(0, object.value("min_size").toInt(m_minimumSize));
+    m_maximumSize = qMax(1, object.value("max_size").toInt(m_maximumSize));
+    m_maximumIdleTime = object.value("max_idle_time").toInt(m_maximumIdleTime);
+    m_healthCheckInterval = object.value("health_check_interval").toInt(m_healthCheckInterval);
+}
+
+void ConnectionPool::save(QJsonObject *object) const
+{
+    QMutexLocker locker(&m_mutex);
+    object->insert("min_size", m_minimumSize);
+    object->insert("max_size", m_maximumSize);
+    object->insert("max_idle_time", m_maximumIdleTime);
+    object->insert("health_check_interval", m_healthCheckInterval);
+}
+
+int ConnectionPool::findConnection(QThread *thread, bool idle) const
+{
+    int found = -1;
+    for (qsizetype i = 0; i < m_connections.size(); ++i) {
+        const Connection &connection = m_connections.at(i);
+        if (connection.thread != thread)
+            continue;
+
+        // A connection already checked out by this thread has priority
+        if (connection.refs > 0 && !idle)
+            return i;
+
+        if (connection.refs == 0 && found < 0)
+            found = i;
+    }
+    return found;
+}
+
+int ConnectionPool::createConnection()
+{
+    Connection connection;
+    connection.name = m_templateName + '_' + QString::number(m_nextId++);
+    connection.thread = QThread::currentThread();
+    connection.releaseTime = QDateTime::currentMSecsSinceEpoch();
+    connection.checkTime = connection.releaseTime;
+
+    QSqlDatabase::cloneDatabase(m_templateName, connection.name);
+
+    m_connections.append(connection);
+    return m_connections.size() - 1;
+}
+
+bool ConnectionPool::removeConnection(int index)
+{
+    const Connection connection = m_connections.at(index);
+
+    // The template is only closed, it is needed for future clones
+    if (connection.name == m_templateName) {
+        QSqlDatabase db = QSqlDatabase::database(connection.name, false);
+        if (db.isOpen())
+            db.close();
+        return false;
+    }
+
+    m_connections.removeAt(index);
+
+    // Only the owner thread can close the connection
+    if (connection.thread == QThread::currentThread()) {
+        QSqlDatabase db = QSqlDatabase::database(connection.name, false);
+        if (db.isOpen())
+            db.close();
+    }
+
+    QSqlDatabase::removeDatabase(connection.name);
+    return true;
+}
+
+bool ConnectionPool::checkConnection(const QString &name)
+{
+    QSqlDatabase db = QSqlDatabase::database(name, false);
+    if (!db.isOpen())
+        return db.open();
+
+    {
+        QSqlQuery query(db);
+        if (query.exec(QStringLiteral("SELECT 1")))
+            return true;
+    }
+
+    db.close();
+    return db.open();
+}
+
+} // namespace Sql
+} // namespace RestLink
@@ -0,0 +1,85 @@
+#ifndef CONNECTIONPOOL_H
+#define CONNECTIONPOOL_H
+
+#include <global.h>
+
+#include <QtCore/qstring.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qwaitcondition.h>
+
+#include <QtSql/qsqldatabase.h>
+
+class QJsonObject;
+
+namespace RestLink {
+namespace Sql {
+
+class SQL_EXPORT ConnectionPool final
+{
+public:
+    explicit ConnectionPool(const QString &connectionName);
+    ~ConnectionPool();
+
+    int minimumSize() const;
+    void setMinimumSize(int size);
+
+    int maximumSize() const;
+    void setMaximumSize(int size);
+
+    int maximumIdleTime() const;
+    void setMaximumIdleTime(int secs);
+
+    int healthCheckInterval() const;
+    void setHealthCheckInterval(int secs);
+
+    int size() const;
+    int idleCount() const;
+
+    QSqlDatabase database();
+    QSqlDatabase acquire(int timeout = 30000);
+    void release();
+
+    int evictIdleConnections(bool force = false);
+    void clear();
+
+    void load(const QJsonObject &object);
+    void save(QJsonObject *object) const;
+
+private:
+    struct Connection {
+        QString name;
+        QPointer<QThread> thread;
+        qint64 releaseTime = 0;
+        qint64 checkTime = 0;
+        int refs = 0;
+        bool stale = false;
+    };
+
+    int findConnection(QThread *thread, bool idle) const;
+    int createConnection();
+    bool removeConnection(int index);
+
+    static bool checkConnection(const QString &name);
+
+    const QString m_templateName;
+
+    int m_minimumSize;
+    int m_maximumSize;
+    int m_maximumIdleTime;
+    int m_healthCheckInterval;
+
+    QList<Connection> m_connections;
+    int m_waiters;
+    int m_nextId;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_released;
+};
+
+} // namespace Sql
+} // namespace RestLink
+
+#endif // CONNECTIONPOOL_H
@@ -95,6 +95,11 @@ void Model::setField(const QString &name, const QVariant &value)
         d_ptr->data.remove(name);
 }
 
+QVariantHash Model::data() const
+{
+    return d_ptr->data;
+}
+
 Relation Model::relation(const QString &name) const
 {
     return d_ptr->relations.value(name);
@@ -102,47 +107,25 @@ Relation Model::relation(const QString &name) const
 
 void Model::fill(const QJsonObject &data, FillMode mode)
 {
-    const ResourceInfo resource = d_ptr->resource;
+    const ResourceInfo &resource = d_ptr->resource;
+    const int fillable = (ResourceInfo::NormalFillable << mode);
 
-    QStringList fieldNames = resource.fillableFields();
-    switch (mode) {
-    case FullFill:
-        fieldNames.prepend(resource.primaryKey());
-
-    case ExtendedFill:
-        if (resource.hasHiddenFields())
-            fieldNames.append(resource.hiddenFields());
-        if (resource.hasCreationTimestamp())
-            fieldNames.append(resource.creationTimestampField());
-        if (resource.hasUpdateTimestamp())
-            fieldNames.append(resource.updateTimestampField());
-
-    default:
-        break;
-    }
+    for (auto it = data.constBegin(); it != data.constEnd(); ++it) {
+        const QString input = it.key();
+        const ResourceInfo::FieldSlot slot = resource.fieldSlot(input);
 
-    const QStringList relationNames = d_ptr->resource.relationNames();
-    const QStringList inputs = data.keys();
-
-    for (const QString &input : inputs) {
-        const QJsonValue value = data.value(input);
-
-        if (fieldNames.contains(input)) {
-            d_ptr->data.insert(input, value.toVariant());
+        if (slot.flags & fillable) {
+            d_ptr->data.insert(input, it.value().toVariant());
+        } else if (!(slot.flags & ResourceInfo::RelationKey)) {
+            continue;
         } else if (d_ptr->relations.contains(input)) {
-            d_ptr->relations[input].fill(value);
-        } else if (relationNames.contains(input)) {
+            d_ptr->relations[input].fill(it.value());
+        } else {
             Relation relation(input, this);
-            relation.fill(value);
+            relation.fill(it.value());
             d_ptr->relations.insert(input, relation);
         }
     }
-
-    return;
-    for (Relation &relation : d_ptr->relations) {
-        const QJsonValue value = data.value(relation.relationName());
-        relation.fill(value);
-    }
 }
 
 void Model::fill(const QSqlRecord &record)
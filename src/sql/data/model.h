@@ -46,6 +46,7 @@ public:
 
     QVariant field(const QString &name) const;
     void setField(const QString &name, const QVariant &value);
+    QVariantHash data() const;
 
     Relation relation(const QString &name) const;
 
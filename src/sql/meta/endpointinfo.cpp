@@ -1,6 +1,7 @@
 #include "endpointinfo.h"
 
 #include <api.h>
+#include <utils/resultcache.h>
 
 #include <QtCore/qjsonobject.h>
 
@@ -13,6 +14,7 @@ public:
     QString name;
     SqlQueryInfo getQuery;
     ResourceInfo resource;
+    ResultCachePolicy cache;
 };
 
 EndpointInfo::EndpointInfo()
@@ -61,6 +63,11 @@ ResourceInfo EndpointInfo::resource() const
     return d_ptr->resource;
 }
 
+ResultCachePolicy EndpointInfo::cachePolicy() const
+{
+    return d_ptr->cache;
+}
+
 void EndpointInfo::load(const QString &name, const QJsonObject &object, Api *api)
 {
     d_ptr->name = name;
@@ -72,6 +79,8 @@ void EndpointInfo::load(const QString &name, const QJsonObject &object, Api *api
         const QString resourceName = object.value("resource").toString();
         d_ptr->resource = api->resourceInfo(resourceName);
     }
+
+    d_ptr->cache.load(object.value("cache").toObject());
 }
 
 void EndpointInfo::save(QJsonObject *object) const
@@ -84,6 +93,12 @@ void EndpointInfo::save(QJsonObject *object) const
 
     if (d_ptr->resource.isValid())
         object->insert("resource", d_ptr->resource.name());
+
+    if (d_ptr->cache.isEnabled()) {
+        QJsonObject cache;
+        d_ptr->cache.save(&cache);
+        object->insert("cache", cache);
+    }
 }
 
 EndpointInfo EndpointInfo::fromResource(const ResourceInfo &resource)
@@ -93,6 +108,7 @@ EndpointInfo EndpointInfo::fromResource(const ResourceInfo &resource)
     EndpointInfoData *data = endpoint.d_ptr.get();
     data->name = '/' + resource.name();
     data->resource = resource;
+    data->cache = resource.cachePolicy();
 
     return endpoint;
 }
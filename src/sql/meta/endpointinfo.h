@@ -10,6 +10,8 @@
 namespace RestLink {
 namespace Sql {
 
+class ResultCachePolicy;
+
 class EndpointInfoData;
 class SQL_EXPORT EndpointInfo : public ParsedData
 {
@@ -28,6 +30,8 @@ public:
     bool hasResource() const;
     ResourceInfo resource() const;
 
+    ResultCachePolicy cachePolicy() const;
+
     void load(const QString &name, const QJsonObject &object, Api *api);
     void save(QJsonObject *object) const;
 
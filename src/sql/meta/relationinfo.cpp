@@ -7,6 +7,8 @@
 #include <data/relation.h>
 #include <data/model.h>
 
+#include <utils/schemacache.h>
+
 #include <QtCore/qjsonobject.h>
 
 #include <QtSql/qsqlrecord.h>
@@ -165,7 +167,7 @@ void RelationInfo::load(const QString &name, const QJsonObject &object, const Re
     endParsing();
 
     if (!d->intermediate.isEmpty())
-        d->intermediateRecord = api->database().record(d->intermediate);
+        d->intermediateRecord = api->schema()->record(d->intermediate, api);
 }
 
 void RelationInfo::save(QJsonObject *object) const
@@ -4,6 +4,8 @@
 #include <api.h>
 #include <meta/relationinfo.h>
 #include <utils/querybuilder.h>
+#include <utils/schemacache.h>
+#include <utils/resultcache.h>
 
 #include <QtCore/qjsonobject.h>
 #include <QtCore/qjsonarray.h>
@@ -28,8 +30,13 @@ public:
     QString createdAtField;
     QString updatedAtField;
     QSqlRecord record;
+    QStringList fieldNames;
+    QHash<QString, int> fieldIndexes;
+    QList<QMetaType> fieldTypes;
+    QHash<QString, ResourceInfo::FieldSlot> fillPlan; // Fields and relations by input key
     QHash<QString, RelationInfo> relations;
     bool loadRelations = false;
+    ResultCachePolicy cache;
 };
 
 ResourceInfo::ResourceInfo()
@@ -120,22 +127,41 @@ QStringList ResourceInfo::hiddenFields() const
     return d->hiddenFields;
 }
 
+bool ResourceInfo::hasField(const QString &name) const
+{
+    return d->fieldIndexes.contains(name);
+}
+
+int ResourceInfo::fieldIndex(const QString &name) const
+{
+    return d->fieldIndexes.value(name, -1);
+}
+
 QMetaType ResourceInfo::fieldType(const QString &name) const
 {
-    return d->record.field(name).metaType();
+    const int index = d->fieldIndexes.value(name, -1);
+    return (index >= 0 ? d->fieldTypes.at(index) : QMetaType());
 }
 
 QSqlField ResourceInfo::field(const QString &name) const
 {
-    return d->record.field(name);
+    const int index = d->fieldIndexes.value(name, -1);
+    return (index >= 0 ? d->record.field(index) : QSqlField());
 }
 
 QStringList ResourceInfo::fieldNames() const
 {
-    QStringList names;
-    for (int i(0); i < d->record.count(); ++i)
-        names.append(d->record.fieldName(i));
-    return names;
+    return d->fieldNames;
+}
+
+QList<QMetaType> ResourceInfo::fieldTypes() const
+{
+    return d->fieldTypes;
+}
+
+ResourceInfo::FieldSlot ResourceInfo::fieldSlot(const QString &name) const
+{
+    return d->fillPlan.value(name);
 }
 
 QSqlRecord ResourceInfo::record() const
@@ -163,6 +189,11 @@ bool ResourceInfo::loadRelations() const
     return d->loadRelations;
 }
 
+ResultCachePolicy ResourceInfo::cachePolicy() const
+{
+    return d->cache;
+}
+
 bool ResourceInfo::isValid() const
 {
     return !d->name.isEmpty()
@@ -176,10 +207,21 @@ void ResourceInfo::load(const QString &name, const QJsonObject &object, Api *api
     d->name = name;
 
     const QString table = object.value("table").toString();
-    const QSqlRecord record = api->database().record(table);
+    const QSqlRecord record = api->schema()->record(table, api);
 
     d->record = record;
 
+    // Per-request lookups by field name must not scan the record
+    d->fieldNames.clear();
+    d->fieldIndexes.clear();
+    d->fieldTypes.clear();
+    for (int i(0); i < record.count(); ++i) {
+        const QSqlField field = record.field(i);
+        d->fieldNames.append(field.name());
+        d->fieldIndexes.insert(field.name(), i);
+        d->fieldTypes.append(field.metaType());
+    }
+
     auto findPrimaryKey = [&table, &api](const QJsonObject &) -> QString {
         return DatabaseUtils::primaryKeyOn(table, api);
     };
@@ -235,6 +277,8 @@ void ResourceInfo::load(const QString &name, const QJsonObject &object, Api *api
 
     endParsing();
 
+    d->cache.load(object.value("cache").toObject());
+
     const QJsonObject relations = object.value("relations").toObject();
     const QStringList relationNames = relations.keys();
     for (const QString &name : relationNames) {
@@ -243,6 +287,36 @@ void ResourceInfo::load(const QString &name, const QJsonObject &object, Api *api
         if (true)
             d->relations.insert(name, info);
     }
+
+    // Fill plan, saves models from matching every input key against field lists
+    d->fillPlan.clear();
+    for (int i(0); i < d->fieldNames.size(); ++i) {
+        FieldSlot slot;
+        slot.index = i;
+        slot.type = d->fieldTypes.at(i);
+        d->fillPlan.insert(d->fieldNames.at(i), slot);
+    }
+
+    auto addFlags = [this](const QString &field, int flags) {
+        auto it = d->fillPlan.find(field);
+        if (it != d->fillPlan.end())
+            it->flags |= flags;
+    };
+
+    for (const QString &field : std::as_const(d->fillableProperties))
+        addFlags(field, NormalFillable | ExtendedFillable | FullFillable);
+
+    for (const QString &field : std::as_const(d->hiddenFields))
+        addFlags(field, ExtendedFillable | FullFillable);
+    addFlags(d->createdAtField, ExtendedFillable | FullFillable);
+    addFlags(d->updatedAtField, ExtendedFillable | FullFillable);
+
+    addFlags(d->primaryKey, FullFillable);
+
+    for (auto it = d->relations.constBegin(); it != d->relations.constEnd(); ++it) {
+        FieldSlot &slot = d->fillPlan[it.key()];
+        slot.flags |= RelationKey;
+    }
 }
 
 void ResourceInfo::save(QJsonObject *object) const
@@ -274,6 +348,12 @@ void ResourceInfo::save(QJsonObject *object) const
 
     if (!relations.isEmpty())
         object->insert("relations", relations);
+
+    if (d->cache.isEnabled()) {
+        QJsonObject cache;
+        d->cache.save(&cache);
+        object->insert("cache", cache);
+    }
 }
 
 ResourceInfo ResourceInfo::pivotResourceInfo(const QString &name, const QString table, const ResourceInfo &main, const ResourceInfo &foreign, Api *api)
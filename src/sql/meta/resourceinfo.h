@@ -7,6 +7,7 @@
 
 #include <QtCore/qshareddata.h>
 #include <QtCore/qlist.h>
+#include <QtCore/qmetatype.h>
 
 class QJsonObject;
 class QSqlField;
@@ -16,12 +17,27 @@ namespace RestLink {
 namespace Sql {
 
 class RelationInfo;
+class ResultCachePolicy;
 class Api;
 
 class ResourceInfoData;
 class SQL_EXPORT ResourceInfo final : public ParsedData
 {
 public:
+    enum FillFlag {
+        NormalFillable = 0x1,
+        ExtendedFillable = 0x2,
+        FullFillable = 0x4,
+        RelationKey = 0x8
+    };
+
+    // What an input key maps to, resolved once when the resource is loaded
+    struct FieldSlot {
+        int index = -1; // Column ordinal, -1 for relations and unknown keys
+        QMetaType type;
+        int flags = 0;
+    };
+
     ResourceInfo();
     ResourceInfo(const ResourceInfo &other);
     ResourceInfo(ResourceInfo &&other);
@@ -46,9 +62,13 @@ public:
     bool hasHiddenFields() const;
     QStringList hiddenFields() const;
 
+    bool hasField(const QString &name) const;
+    int fieldIndex(const QString &name) const;
     QMetaType fieldType(const QString &name) const;
     QSqlField field(const QString &name) const;
     QStringList fieldNames() const;
+    QList<QMetaType> fieldTypes() const;
+    FieldSlot fieldSlot(const QString &name) const;
     QSqlRecord record() const;
 
     RelationInfo relation(const QString &name) const;
@@ -57,6 +77,8 @@ public:
 
     bool loadRelations() const;
 
+    ResultCachePolicy cachePolicy() const;
+
     bool isValid() const override;
 
     void load(const QString &name, const QJsonObject &object, Api *api);
@@ -1,5 +1,10 @@
 #include "sqlqueryinfo.h"
 
+#include <api.h>
+#include <debug.h>
+
+#include <utils/queryrunner.h>
+
 #include <QtCore/qvariant.h>
 #include <QtCore/qjsonobject.h>
 
@@ -9,6 +14,169 @@ namespace Sql {
 class SqlQueryInfoData : public QSharedData
 {
 public:
+    struct Parameter {
+        QString name;
+        bool quoted = false; // Placeholders written inside quotes are text
+    };
+
+    struct CompiledStatement {
+        QString statement; // Placeholders replaced by '?'
+        QString mysqlStatement; // Same, with partial literals concatenated the MySQL way
+        QList<Parameter> parameters; // Bound in order
+    };
+
+    bool compile()
+    {
+        compiled.clear();
+        for (const QString &statement : std::as_const(statements)) {
+            CompiledStatement statementData;
+            if (!compile(statement, &statementData)) {
+                sqlWarning() << "Placeholders can't be used in double-quoted text: " << statement;
+                compiled.clear();
+                return false;
+            }
+            compiled.append(statementData);
+        }
+        return true;
+    }
+
+    static bool compile(const QString &statement, CompiledStatement *compiled)
+    {
+        compiled->statement.reserve(statement.size());
+
+        auto append = [compiled](const QString &text) {
+            compiled->statement.append(text);
+            compiled->mysqlStatement.append(text);
+        };
+
+        qsizetype i = 0;
+        while (i < statement.size()) {
+            const QChar c = statement.at(i);
+
+            if (c == '\'' || c == '"') {
+                // Finding the literal end, doubled quotes being escaped ones
+                qsizetype end = i + 1;
+                while (end < statement.size()) {
+                    if (statement.at(end) == c) {
+                        if (end + 1 < statement.size() && statement.at(end + 1) == c)
+                            end += 2;
+                        else
+                            break;
+                    } else {
+                        ++end;
+                    }
+                }
+
+                const QString content = statement.mid(i + 1, end - i - 1);
+                i = end + 1;
+
+                if (!content.contains(QStringLiteral("{{"))) {
+                    append(c + content + (end < statement.size() ? QString(c) : QString()));
+                    continue;
+                }
+
+                // Identifiers on most databases, strings on MySQL, neither can take a value safely
+                if (c == '"')
+                    return false;
+
+                QStringList parts;
+                qsizetype start = 0;
+                while (start < content.size()) {
+                    const qsizetype open = content.indexOf(QStringLiteral("{{"), start);
+                    const qsizetype close = (open < 0 ? -1 : content.indexOf(QStringLiteral("}}"), open + 2));
+                    if (close < 0) {
+                        parts.append('\'' + content.mid(start) + '\'');
+                        break;
+                    }
+
+                    if (open > start)
+                        parts.append('\'' + content.mid(start, open - start) + '\'');
+
+                    parts.append(QStringLiteral("?"));
+                    compiled->parameters.append({ content.mid(open + 2, close - open - 2).trimmed(), true });
+                    start = close + 2;
+                }
+
+                if (parts.size() == 1) {
+                    // '{{name}}' is bound as a whole, quotes included
+                    append(parts.constFirst());
+                } else {
+                    // Partial literals become expressions, values are still bound
+                    compiled->statement.append('(' + parts.join(QStringLiteral(" || ")) + ')');
+                    compiled->mysqlStatement.append(QStringLiteral("CONCAT(") + parts.join(QStringLiteral(", ")) + ')');
+                }
+                continue;
+            }
+
+            if (c != '{' || i + 1 >= statement.size() || statement.at(i + 1) != '{') {
+                append(c);
+                ++i;
+                continue;
+            }
+
+            const qsizetype end = statement.indexOf(QStringLiteral("}}"), i + 2);
+            if (end < 0) {
+                append(statement.mid(i));
+                break;
+            }
+
+            append(QStringLiteral("?"));
+            compiled->parameters.append({ statement.mid(i + 2, end - i - 2).trimmed(), false });
+            i = end + 2;
+        }
+
+        return true;
+    }
+
+    QVariant value(const Parameter &parameter, const QVariantHash &data) const
+    {
+        const QVariant defaultValue = parameters.value(parameter.name);
+        if (!data.contains(parameter.name))
+            return (parameter.quoted && defaultValue.isValid() ? QVariant(defaultValue.toString()) : defaultValue);
+
+        QVariant value = data.value(parameter.name);
+
+        // Quoted placeholders are text, whatever they look like
+        if (parameter.quoted)
+            return value.toString();
+
+        // Request values are text, defaults from the configuration tell us what they should be
+        if (defaultValue.isValid() && !defaultValue.isNull()) {
+            QVariant converted = value;
+            if (converted.convert(defaultValue.metaType()))
+                return converted;
+        }
+
+        if (value.typeId() == QMetaType::QString) {
+            const QString text = value.toString();
+            bool ok = false;
+
+            const qlonglong integer = text.toLongLong(&ok);
+            if (ok)
+                return integer;
+
+            const double real = text.toDouble(&ok);
+            if (ok)
+                return real;
+        }
+
+        return value;
+    }
+
+    Query query(const CompiledStatement &compiled, const QVariantHash &data, bool mysql) const
+    {
+        Query query;
+        query.statement = (mysql ? compiled.mysqlStatement : compiled.statement);
+        query.array = !object;
+
+        for (const Parameter &parameter : compiled.parameters) {
+            const QVariant value = this->value(parameter, data);
+            query.values.append(value.isValid() ? value : QVariant(QMetaType::fromType<QString>()));
+        }
+
+        return query;
+    }
+
     QString format(const QString &query, const QVariantHash &data) const
     {
         QString output = query;
@@ -25,6 +193,7 @@ public:
     }
 
     QStringList statements;
+    QList<CompiledStatement> compiled;
     QVariantHash parameters;
     bool object = false;
 };
@@ -76,6 +245,19 @@ QStringList SqlQueryInfo::allFormated(const QVariantHash &data) const
     return queries;
 }
 
+QList<Query> SqlQueryInfo::queries(const QVariantHash &data, Api *api) const
+{
+    // Partial literals are concatenated with CONCAT() on MySQL, || being a logical OR there
+    const QString driverName = (api ? api->database().driverName() : QString());
+    const bool mysql = (driverName == "QMYSQL" || driverName == "QMARIADB");
+
+    QList<Query> queries;
+    queries.reserve(d_ptr->compiled.size());
+    for (const SqlQueryInfoData::CompiledStatement &compiled : std::as_const(d_ptr->compiled))
+        queries.append(d_ptr->query(compiled, data, mysql));
+    return queries;
+}
+
 QVariant SqlQueryInfo::parameterValue(const QString &name) const
 {
     return d_ptr->parameters.value(name);
@@ -114,6 +296,10 @@ void SqlQueryInfo::load(const QJsonObject &object)
     attribute("object", false, &d_ptr->object);
     attribute("parameters", &d_ptr->parameters);
     endParsing();
+
+    // Statements with unsafe placeholders are dropped, the query is then invalid
+    if (!d_ptr->compile())
+        d_ptr->statements.clear();
 }
 
 void SqlQueryInfo::save(QJsonObject *object) const
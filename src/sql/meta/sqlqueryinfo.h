@@ -10,6 +10,9 @@
 namespace RestLink {
 namespace Sql {
 
+class Query;
+class Api;
+
 class SqlQueryInfoData;
 class SQL_EXPORT SqlQueryInfo : public ParsedData
 {
@@ -26,6 +29,8 @@ public:
     QStringList statements() const;
     QStringList allFormated(const QVariantHash &data) const;
 
+    QList<Query> queries(const QVariantHash &data, Api *api = nullptr) const;
+
     QVariant parameterValue(const QString &name) const;
     QStringList parameterNames() const;
 
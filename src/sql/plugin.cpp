@@ -3,8 +3,6 @@
 
 #include <routing/router.h>
 
-#include <QtCore/qcoreapplication.h>
-
 #include <QtSql/qsqldatabase.h>
 
 namespace RestLink {
@@ -29,7 +27,8 @@ public:
             return name.mid(1).toLower();
         });
 
-        return Server::create<Router>(QStringLiteral("SQL"), schemes, qApp);
+        // Created by any thread, the plugin manager hands it over to the application
+        return Server::create<Router>(QStringLiteral("SQL"), schemes);
     }
 };
 
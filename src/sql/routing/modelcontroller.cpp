@@ -2,9 +2,13 @@
 
 #include <api.h>
 #include <data/model.h>
+#include <meta/relationinfo.h>
 #include <utils/jsonutils.h>
+#include <utils/queryrunner.h>
+#include <utils/resultcache.h>
 
 #include <QtCore/qjsonarray.h>
+#include <QtCore/qregularexpression.h>
 
 #include <QtSql/qsqldatabase.h>
 #include <QtSql/qsqlerror.h>
@@ -12,10 +16,20 @@
 
 #include <RestLink/serverrequest.h>
 #include <RestLink/serverresponse.h>
+#include <RestLink/body.h>
 
 #define PARAM_WITH_RELATIONS "with_relations"
 #define PARAM_PAGE           "page"
 #define PARAM_LIMIT          "limit"
+#define PARAM_FIELDS         "fields"
+#define PARAM_FILTER         "filter"
+#define PARAM_SORT           "sort"
+#define PARAM_ON_CONFLICT    "on_conflict"
+#define PARAM_CONFLICT_KEYS  "conflict_keys"
+#define PARAM_IDS            "ids"
+#define PARAM_STREAM         "stream"
+
+#define BULK_INSERT_BATCH_SIZE 500
 
 namespace RestLink {
 namespace Sql {
@@ -41,7 +55,18 @@ void ModelController::index(const ServerRequest &request, ServerResponse *respon
 {
     QueryOptions options;
 
-    options.withRelations = requestedRelations(request, requestedResource(request));
+    const ResourceInfo resource = requestedResource(request);
+    options.withRelations = requestedRelations(request, resource);
+    options.fields = requestedFields(request, resource, options.withRelations);
+
+    QString optionsError;
+    if (!requestedFilters(request, resource, &options, &optionsError)
+        || !requestedSorting(request, resource, &options, &optionsError)) {
+        response->setHttpStatusCode(400);
+        response->setBody(QJsonObject({ { "message", optionsError } }));
+        response->complete();
+        return;
+    }
 
     if (request.hasQueryParameter(PARAM_LIMIT))
         options.limit = request.queryParameterValues(PARAM_LIMIT).constFirst().toInt();
@@ -59,8 +84,35 @@ void ModelController::index(const ServerRequest &request, ServerResponse *respon
         options.offset = (page - 1) * options.limit;
     }
 
+    QString stream;
+    if (request.hasQueryParameter(PARAM_STREAM) && options.withRelations.isEmpty())
+        stream = request.queryParameterValues(PARAM_STREAM).constFirst().toString();
+
+    // Streamed pages are never cached, their size is unknown upfront
+    QByteArray cacheKey;
+    if (m_resource.cachePolicy().isEnabled() && stream.isEmpty()) {
+        cacheKey = ResultCache::keyOf(QueryBuilder::selectStatement(m_resource, options, m_api), { page, options.withRelations.join(',') });
+
+        QByteArray output;
+        if (m_api->resultCache()->find(m_resource.name(), cacheKey, &output)) {
+            response->setHttpStatusCode(200);
+            response->setBody(Body(output, RESTLINK_MIME_JSON));
+            response->complete();
+            return;
+        }
+    }
+
+    const quint64 generation = m_api->resultCache()->generation();
+
+    // Without relations, rows don't need to become models
+    if (options.withRelations.isEmpty()) {
+        indexRecords(options, page, stream, response, cacheKey, generation);
+        return;
+    }
+
     QJsonObject json;
     QJsonArray result;
+    QByteArray output;
     int count;
 
     QSqlQuery query(m_api->database());
@@ -77,16 +129,17 @@ success:
         result.append(model.jsonObject());
     count = Model::count(m_resource, options, m_api);
 
+    json = paginationObject(options, page, models.count(), count);
     json.insert("data", result);
-    json.insert("from", options.offset + 1);
-    json.insert("to", options.offset + models.count());
-    json.insert("total", count);
-    json.insert("current_page", page);
-    json.insert("per_page", options.limit);
-    json.insert("last_page", options.limit > 0 ? qCeil<double>(count / double(options.limit)) : 1);
 
     response->setHttpStatusCode(200);
-    response->setBody(json);
+    if (cacheKey.isEmpty()) {
+        response->setBody(json);
+    } else {
+        JsonUtils::writeObject(json, &output);
+        cacheResult(cacheKey, output, options, generation);
+        response->setBody(Body(output, RESTLINK_MIME_JSON));
+    }
     response->complete();
     return;
 
@@ -98,6 +151,77 @@ error:
     return;
 }
 
+void ModelController::indexRecords(const QueryOptions &options, int page, const QString &stream, ServerResponse *response, const QByteArray &cacheKey, quint64 generation)
+{
+    bool success = false;
+    QSqlQuery query = QueryRunner::exec(QueryBuilder::selectStatement(m_resource, options, m_api), m_api, &success);
+    if (!success) {
+        response->setHttpStatusCode(httpStatusCodeFromSqlError(query.lastError().type()));
+        response->setBody(JsonUtils::objectFromQuery(query));
+        response->complete();
+        return;
+    }
+
+    const JsonRecordWriter writer(query.record(), m_resource.hiddenFields());
+
+    // Streamed rows are sent as they are fetched, NDJSON ones without pagination
+    JsonRecordWriter::Flush flush;
+    if (!stream.isEmpty()) {
+        response->setHttpStatusCode(200);
+        response->setBody(Body(QByteArray(), stream == "ndjson" ? RESTLINK_MIME_NDJSON : RESTLINK_MIME_JSON));
+        flush = [response](const QByteArray &chunk) { return response->writeBody(chunk); };
+    }
+
+    QByteArray output;
+
+    if (stream == "ndjson") {
+        writer.writeLines(&query, &output, flush);
+        response->writeBody(output);
+        response->complete();
+        return;
+    }
+
+    output.append("{\"data\":");
+
+    const int rows = writer.writeArray(&query, &output, flush);
+
+    // The client stopped reading, the response is already over
+    if (flush && response->isAborted())
+        return;
+
+    const int count = Model::count(m_resource, options, m_api);
+
+    // Pagination members are appended to the data object
+    QByteArray pagination;
+    JsonUtils::writeObject(paginationObject(options, page, rows, count), &pagination);
+    pagination[0] = ',';
+    output.append(pagination);
+
+    response->setHttpStatusCode(200);
+    if (flush) {
+        response->writeBody(output);
+    } else {
+        if (!cacheKey.isEmpty())
+            cacheResult(cacheKey, output, options, generation);
+        response->setBody(Body(output, RESTLINK_MIME_JSON));
+    }
+    response->complete();
+}
+
+void ModelController::cacheResult(const QByteArray &key, const QByteArray &data, const QueryOptions &options, quint64 generation)
+{
+    // Pages are dropped whenever one of the tables they were read from gets written
+    QStringList tables = { m_resource.table() };
+    for (const QString &name : options.withRelations) {
+        const RelationInfo relation = m_resource.relation(name);
+        tables.append(relation.table());
+        if (!relation.pivot().isEmpty())
+            tables.append(relation.pivot());
+    }
+
+    m_api->resultCache()->insert(m_resource.name(), key, data, tables, m_resource.cachePolicy(), generation);
+}
+
 void ModelController::show(const ServerRequest &request, ServerResponse *response)
 {
     Model model = requestModel(request);
@@ -124,6 +248,11 @@ error:
 
 void ModelController::update(const ServerRequest &request, ServerResponse *response)
 {
+    if (!request.identifier().isValid()) {
+        updateMultiple(request, response);
+        return;
+    }
+
     Model model = requestModel(request);
     model.fill(request.body().jsonObject());
     if (model.update())
@@ -146,6 +275,17 @@ error:
 
 void ModelController::store(const ServerRequest &request, ServerResponse *response)
 {
+    const Body body = request.body();
+    if (body.hasJsonArray()) {
+        storeMultiple(request, body.jsonArray(), response);
+        return;
+    }
+
+    if (request.hasQueryParameter(PARAM_ON_CONFLICT)) {
+        storeMultiple(request, QJsonArray({ body.jsonObject() }), response);
+        return;
+    }
+
     Model model = requestModel(request);
     model.fill(request.body().jsonObject());
     if (model.insert())
@@ -165,8 +305,162 @@ error:
     return;
 }
 
+void ModelController::storeMultiple(const ServerRequest &request, const QJsonArray &objects, ServerResponse *response)
+{
+    QueryBuilder::ConflictMode mode = QueryBuilder::ConflictFail;
+    if (request.hasQueryParameter(PARAM_ON_CONFLICT)) {
+        const QString value = request.queryParameterValues(PARAM_ON_CONFLICT).constFirst().toString();
+        if (value == "ignore")
+            mode = QueryBuilder::ConflictIgnore;
+        else if (value == "update")
+            mode = QueryBuilder::ConflictUpdate;
+        else if (value != "fail") {
+            response->setHttpStatusCode(400);
+            response->setBody(QJsonObject({ { "message", QStringLiteral("unsupported conflict mode '%1'").arg(value) } }));
+            response->complete();
+            return;
+        }
+    }
+
+    const QStringList available = m_resource.fieldNames();
+
+    QStringList conflictKeys;
+    if (request.hasQueryParameter(PARAM_CONFLICT_KEYS)) {
+        const QStringList keys = request.queryParameterValues(PARAM_CONFLICT_KEYS).constFirst().toString().split(',', Qt::SkipEmptyParts);
+        for (const QString &key : keys) {
+            // Dropping a key would silently widen what counts as a conflict
+            if (!available.contains(key.trimmed())) {
+                response->setHttpStatusCode(400);
+                response->setBody(QJsonObject({ { "message", QStringLiteral("unknown conflict key '%1'").arg(key.trimmed()) } }));
+                response->complete();
+                return;
+            }
+
+            conflictKeys.append(key.trimmed());
+        }
+    }
+
+    if (conflictKeys.isEmpty() && mode == QueryBuilder::ConflictUpdate)
+        conflictKeys.append(m_resource.primaryKey());
+
+    const QStringList relationNames = m_resource.relationNames();
+    const QString creationField = m_resource.creationTimestampField();
+    const QString updateField = m_resource.updateTimestampField();
+    const QDateTime now = QDateTime::currentDateTime();
+
+    int affectedRows = 0;
+    QJsonObject error;
+
+    // Consecutive rows sharing the same columns are inserted with a single statement
+    QStringList fields;
+    QList<QVariantHash> rows;
+    auto flush = [&]() -> bool {
+        if (rows.isEmpty())
+            return true;
+
+        bool success = false;
+        const QString statement = QueryBuilder::insertStatement(m_resource, fields, rows, mode, conflictKeys, m_api);
+        const QSqlQuery query = QueryRunner::exec(statement, m_api, &success);
+        rows.clear();
+
+        if (!success) {
+            error = JsonUtils::objectFromQuery(query);
+            return false;
+        }
+
+        affectedRows += qMax(0, query.numRowsAffected());
+        return true;
+    };
+
+    for (const QJsonValue &value : objects) {
+        const QJsonObject object = value.toObject();
+
+        Model model(m_resource, m_api);
+        model.fill(object);
+
+        // Nested relations still need the regular insertion path
+        const bool nested = std::any_of(relationNames.begin(), relationNames.end(), [&object](const QString &name) {
+            return object.contains(name);
+        });
+
+        if (nested) {
+            if (!flush())
+                break;
+
+            if (!model.insert()) {
+                error = model.lastQuery();
+                break;
+            }
+
+            ++affectedRows;
+            continue;
+        }
+
+        QVariantHash row = model.data();
+        if (!creationField.isEmpty())
+            row.insert(creationField, now);
+        if (!updateField.isEmpty() && mode == QueryBuilder::ConflictUpdate)
+            row.insert(updateField, now);
+
+        QStringList rowFields;
+        for (const QString &field : available) {
+            if (mode == QueryBuilder::ConflictFail && field == m_resource.primaryKey())
+                continue;
+
+            const QVariant fieldValue = row.value(field);
+            if (fieldValue.isValid() && !fieldValue.isNull())
+                rowFields.append(field);
+        }
+
+        if (rowFields != fields || rows.size() >= BULK_INSERT_BATCH_SIZE) {
+            if (!flush())
+                break;
+            fields = rowFields;
+        }
+
+        rows.append(row);
+    }
+
+    if (error.isEmpty())
+        flush();
+
+    if (!error.isEmpty()) {
+        const QJsonObject sqlError = error.value("error").toObject();
+        response->setHttpStatusCode(sqlError.isEmpty() ? 500 : httpStatusCodeFromSqlError(sqlError));
+        response->setBody(error);
+        response->complete();
+        return;
+    }
+
+    response->setHttpStatusCode(200);
+    response->setBody(QJsonObject({ { "num_rows_affected", affectedRows } }));
+    response->complete();
+}
+
 void ModelController::destroy(const ServerRequest &request, ServerResponse *response)
 {
+    if (!request.identifier().isValid()) {
+        destroyMultiple(request, response);
+        return;
+    }
+
+    // Without relations to process, there is no need to fetch the row first
+    if (m_resource.relationNames().isEmpty()) {
+        QueryOptions options;
+        options.filters.andWhere(m_resource.primaryKey(), request.identifier());
+
+        bool success = false;
+        const QSqlQuery query = QueryRunner::exec(QueryBuilder::deleteStatement(m_resource, options, m_api), m_api, &success);
+        if (!success) {
+            response->setHttpStatusCode(httpStatusCodeFromSqlError(query.lastError().type()));
+            response->setBody(JsonUtils::objectFromQuery(query));
+        } else {
+            response->setHttpStatusCode(query.numRowsAffected() > 0 ? 200 : 404);
+        }
+        response->complete();
+        return;
+    }
+
     Model model = requestModel(request);
 
     if (!model.get(request.identifier().toInt())) {
@@ -186,6 +480,153 @@ void ModelController::destroy(const ServerRequest &request, ServerResponse *resp
     response->complete();
 }
 
+void ModelController::updateMultiple(const ServerRequest &request, ServerResponse *response)
+{
+    QueryOptions options;
+    if (!requestedTargets(request, &options, response))
+        return;
+
+    const QJsonObject object = request.body().jsonObject();
+
+    // Nested relations are processed row by row, like single updates
+    const QStringList relationNames = m_resource.relationNames();
+    const bool nested = std::any_of(relationNames.begin(), relationNames.end(), [&object](const QString &name) {
+        return object.contains(name);
+    });
+
+    if (nested) {
+        processTargets(options, [&object](Model &model) {
+            model.fill(object, Model::NormalFill);
+            return model.update();
+        }, response);
+        return;
+    }
+
+    Model model(m_resource, m_api);
+    model.fill(object, Model::NormalFill);
+
+    QVariantHash data = model.data();
+    if (m_resource.hasUpdateTimestamp())
+        data.insert(m_resource.updateTimestampField(), QDateTime::currentDateTime());
+
+    const QString statement = QueryBuilder::updateStatement(m_resource, data, options, m_api);
+    if (statement.isEmpty()) {
+        response->setHttpStatusCode(400);
+        response->setBody(QJsonObject({ { "message", "nothing to update" } }));
+        response->complete();
+        return;
+    }
+
+    bool success = false;
+    const QSqlQuery query = QueryRunner::exec(statement, m_api, &success);
+    response->setHttpStatusCode(success ? 200 : httpStatusCodeFromSqlError(query.lastError().type()));
+    response->setBody(JsonUtils::objectFromQuery(query));
+    response->complete();
+}
+
+void ModelController::destroyMultiple(const ServerRequest &request, ServerResponse *response)
+{
+    QueryOptions options;
+    if (!requestedTargets(request, &options, response))
+        return;
+
+    // Relations are processed row by row, like single deletions
+    if (!m_resource.relationNames().isEmpty()) {
+        processTargets(options, [](Model &model) {
+            return model.get() && model.deleteData();
+        }, response);
+        return;
+    }
+
+    bool success = false;
+    const QSqlQuery query = QueryRunner::exec(QueryBuilder::deleteStatement(m_resource, options, m_api), m_api, &success);
+    response->setHttpStatusCode(success ? 200 : httpStatusCodeFromSqlError(query.lastError().type()));
+    response->setBody(JsonUtils::objectFromQuery(query));
+    response->complete();
+}
+
+void ModelController::processTargets(const QueryOptions &options, const std::function<bool(Model &)> &process, ServerResponse *response)
+{
+    const QString primaryKey = m_resource.primaryKey();
+
+    bool success = false;
+    QSqlQuery query = QueryRunner::exec(QueryBuilder::selectStatement(m_resource, options, m_api), m_api, &success);
+    if (!success) {
+        response->setHttpStatusCode(httpStatusCodeFromSqlError(query.lastError().type()));
+        response->setBody(JsonUtils::objectFromQuery(query));
+        response->complete();
+        return;
+    }
+
+    QVariantList ids;
+    while (query.next())
+        ids.append(query.value(primaryKey));
+
+    int affectedRows = 0;
+    for (const QVariant &id : std::as_const(ids)) {
+        Model model(m_resource, m_api);
+        model.setPrimary(id);
+
+        if (!process(model)) {
+            response->setHttpStatusCode(httpStatusCodeFromSqlError(model.lastError()));
+            response->setBody(QJsonObject({ { "num_rows_affected", affectedRows }, { "error", model.lastError() } }));
+            response->complete();
+            return;
+        }
+
+        ++affectedRows;
+    }
+
+    response->setHttpStatusCode(200);
+    response->setBody(QJsonObject({ { "num_rows_affected", affectedRows } }));
+    response->complete();
+}
+
+bool ModelController::requestedTargets(const ServerRequest &request, QueryOptions *options, ServerResponse *response) const
+{
+    QString error;
+    if (!requestedFilters(request, m_resource, options, &error)) {
+        response->setHttpStatusCode(400);
+        response->setBody(QJsonObject({ { "message", error } }));
+        response->complete();
+        return false;
+    }
+
+    // Identifiers can come from the ids query parameter or, on deletion, from a JSON array body
+    QVariantList ids;
+    if (request.hasQueryParameter(PARAM_IDS)) {
+        const QStringList values = request.queryParameterValues(PARAM_IDS).constFirst().toString().split(',', Qt::SkipEmptyParts);
+        for (const QString &value : values)
+            ids.append(value.trimmed());
+    } else if (request.method() == AbstractRequestHandler::DeleteMethod && request.body().hasJsonArray()) {
+        ids = request.body().jsonArray().toVariantList();
+    }
+
+    if (request.hasQueryParameter(PARAM_IDS) || !ids.isEmpty()) {
+        const QMetaType type = m_resource.fieldType(m_resource.primaryKey());
+        for (QVariant &id : ids) {
+            const QString value = id.toString();
+            if (type.isValid() && !id.convert(type)) {
+                response->setHttpStatusCode(400);
+                response->setBody(QJsonObject({ { "message", QStringLiteral("invalid identifier '%1'").arg(value) } }));
+                response->complete();
+                return false;
+            }
+        }
+        options->filters.andWhereIn(m_resource.primaryKey(), ids);
+    }
+
+    // We never touch a whole table by accident
+    if (options->filters.isEmpty()) {
+        response->setHttpStatusCode(400);
+        response->setBody(QJsonObject({ { "message", "filters or identifiers are required" } }));
+        response->complete();
+        return false;
+    }
+
+    return true;
+}
+
 bool ModelController::canProcessRequest(const ServerRequest &request) const
 {
     if (!m_resource.isValid())
@@ -195,6 +636,7 @@ bool ModelController::canProcessRequest(const ServerRequest &request) const
     case AbstractRequestHandler::GetMethod:
     case AbstractRequestHandler::PostMethod:
     case AbstractRequestHandler::PutMethod:
+    case AbstractRequestHandler::PatchMethod:
     case AbstractRequestHandler::DeleteMethod:
         break;
 
@@ -263,6 +705,153 @@ QStringList ModelController::requestedRelations(const ServerRequest &request, co
     return relations;
 }
 
+QStringList ModelController::requestedFields(const ServerRequest &request, const ResourceInfo &resource, const QStringList &relations) const
+{
+    if (!request.hasQueryParameter(PARAM_FIELDS))
+        return QStringList();
+
+    const QStringList hidden = resource.hiddenFields();
+
+    QStringList fields;
+    const QVariantList values = request.queryParameterValues(PARAM_FIELDS);
+    for (const QVariant &value : values) {
+        const QStringList names = value.toString().split(',', Qt::SkipEmptyParts);
+        for (QString name : names) {
+            name = name.trimmed();
+            if (resource.hasField(name) && !hidden.contains(name) && !fields.contains(name))
+                fields.append(name);
+        }
+    }
+
+    // Nothing valid requested, we keep the default projection
+    if (fields.isEmpty())
+        return fields;
+
+    // Primary key is always needed to identify rows
+    if (!fields.contains(resource.primaryKey()))
+        fields.prepend(resource.primaryKey());
+
+    // Relations are resolved through local keys, hidden or not
+    for (const QString &relation : relations) {
+        const QString localKey = resource.relation(relation).localKey();
+        if (resource.hasField(localKey) && !fields.contains(localKey))
+            fields.append(localKey);
+    }
+
+    return fields;
+}
+
+bool ModelController::requestedFilters(const ServerRequest &request, const ResourceInfo &resource, QueryOptions *options, QString *error) const
+{
+    // filter[field]=value or filter[field][op]=value
+    static const QRegularExpression expression(QStringLiteral("^" PARAM_FILTER "\\[(\\w+)\\](?:\\[(\\w+)\\])?$"));
+
+    static const QHash<QString, QString> operators = {
+        { "eq",   "="    },
+        { "ne",   "<>"   },
+        { "gt",   ">"    },
+        { "gte",  ">="   },
+        { "lt",   "<"    },
+        { "lte",  "<="   },
+        { "like", "LIKE" },
+        { "in",   "IN"   }
+    };
+
+    const QStringList hidden = resource.hiddenFields();
+
+    const QStringList names = request.queryParameterNames();
+    for (const QString &name : names) {
+        if (!name.startsWith(PARAM_FILTER "["))
+            continue;
+
+        const QRegularExpressionMatch match = expression.match(name);
+        if (!match.hasMatch()) {
+            if (error) *error = QStringLiteral("malformed filter '%1'").arg(name);
+            return false;
+        }
+
+        // Hidden fields would leak through filters one guess at a time
+        const QString field = match.captured(1);
+        if (!resource.hasField(field) || hidden.contains(field)) {
+            if (error) *error = QStringLiteral("can't filter on unknown field '%1'").arg(field);
+            return false;
+        }
+
+        const QString op = (match.hasCaptured(2) ? match.captured(2).toLower() : QStringLiteral("eq"));
+        if (!operators.contains(op)) {
+            if (error) *error = QStringLiteral("unsupported filter operator '%1'").arg(op);
+            return false;
+        }
+
+        // Values are typed after the column so that the driver formats them properly
+        const QMetaType type = resource.fieldType(field);
+        const QVariantList values = request.queryParameterValues(name);
+        for (QVariant value : values) {
+            // filter[field][in]=v1,v2,v3
+            QVariantList items;
+            if (op == "in") {
+                const QStringList parts = value.toString().split(',', Qt::SkipEmptyParts);
+                for (const QString &part : parts)
+                    items.append(part.trimmed());
+            } else {
+                items.append(value);
+            }
+
+            for (QVariant &item : items) {
+                if (type.isValid() && op != "like" && !item.convert(type)) {
+                    if (error) *error = QStringLiteral("invalid value for filter on '%1'").arg(field);
+                    return false;
+                }
+            }
+
+            if (op == "in")
+                options->filters.andWhereIn(field, items);
+            else
+                options->filters.andWhere(field, operators.value(op), items.constFirst());
+        }
+    }
+
+    return true;
+}
+
+bool ModelController::requestedSorting(const ServerRequest &request, const ResourceInfo &resource, QueryOptions *options, QString *error) const
+{
+    if (!request.hasQueryParameter(PARAM_SORT))
+        return true;
+
+    // sort=field for ascending order, sort=-field for descending order
+    QString field = request.queryParameterValues(PARAM_SORT).constFirst().toString().trimmed();
+
+    Qt::SortOrder order = Qt::AscendingOrder;
+    if (field.startsWith('-')) {
+        order = Qt::DescendingOrder;
+        field.remove(0, 1);
+    } else if (field.startsWith('+')) {
+        field.remove(0, 1);
+    }
+
+    if (!resource.hasField(field) || resource.hiddenFields().contains(field)) {
+        if (error) *error = QStringLiteral("can't sort on unknown field '%1'").arg(field);
+        return false;
+    }
+
+    options->sortField = field;
+    options->sortOrder = order;
+    return true;
+}
+
+QJsonObject ModelController::paginationObject(const QueryOptions &options, int page, int rows, int count)
+{
+    QJsonObject object;
+    object.insert("from", options.offset + 1);
+    object.insert("to", options.offset + rows);
+    object.insert("total", count);
+    object.insert("current_page", page);
+    object.insert("per_page", options.limit);
+    object.insert("last_page", options.limit > 0 ? qCeil<double>(count / double(options.limit)) : 1);
+    return object;
+}
+
 int ModelController::httpStatusCodeFromSqlError(const QJsonObject &error)
 {
     return 500;
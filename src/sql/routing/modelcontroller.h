@@ -6,15 +6,19 @@
 
 #include <QtCore/qstring.h>
 
+#include <functional>
+
 #include <RestLink/resourcecontroller.h>
 
 class QJsonObject;
+class QJsonArray;
 
 namespace RestLink {
 namespace Sql {
 
 class Model;
 class ResourceInfo;
+class QueryOptions;
 
 class Api;
 
@@ -39,11 +43,24 @@ public:
     Model requestModel(const ServerRequest &request) const;
     ResourceInfo requestedResource(const ServerRequest &request) const;
     QStringList requestedRelations(const ServerRequest &request, const ResourceInfo &resource) const;
+    QStringList requestedFields(const ServerRequest &request, const ResourceInfo &resource, const QStringList &relations) const;
+    bool requestedFilters(const ServerRequest &request, const ResourceInfo &resource, QueryOptions *options, QString *error = nullptr) const;
+    bool requestedSorting(const ServerRequest &request, const ResourceInfo &resource, QueryOptions *options, QString *error = nullptr) const;
+
+    static QJsonObject paginationObject(const QueryOptions &options, int page, int rows, int count);
 
     static int httpStatusCodeFromSqlError(const QJsonObject &error);
     static int httpStatusCodeFromSqlError(int type);
 
 private:
+    void storeMultiple(const ServerRequest &request, const QJsonArray &objects, ServerResponse *response);
+    void updateMultiple(const ServerRequest &request, ServerResponse *response);
+    void destroyMultiple(const ServerRequest &request, ServerResponse *response);
+    bool requestedTargets(const ServerRequest &request, QueryOptions *options, ServerResponse *response) const;
+    void processTargets(const QueryOptions &options, const std::function<bool(Model &)> &process, ServerResponse *response);
+    void indexRecords(const QueryOptions &options, int page, const QString &stream, ServerResponse *response, const QByteArray &cacheKey, quint64 generation);
+    void cacheResult(const QByteArray &key, const QByteArray &data, const QueryOptions &options, quint64 generation);
+
     QString m_endpoint;
     ResourceInfo m_resource;
     Api *m_api;
@@ -1,19 +1,29 @@
 #include "router.h"
 #include "utils/querybuilder.h"
 #include "utils/queryrunner.h"
+#include "utils/scriptrunner.h"
 
 #include <api.h>
 #include <meta/endpointinfo.h>
 #include <utils/jsonutils.h>
+#include <utils/resultcache.h>
+#include <utils/latencystats.h>
+#include <utils/databaseutils.h>
+#include <connectionpool.h>
 
 #include <QtCore/qfile.h>
 #include <QtCore/qjsonarray.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qsharedpointer.h>
+#include <QtCore/qpointer.h>
+#include <QtCore/qtimer.h>
 
 #include <QtSql/qsqlerror.h>
 #include <QtSql/qsqlquery.h>
 
 #include <RestLink/serverrequest.h>
 #include <RestLink/serverresponse.h>
+#include <RestLink/body.h>
 #include <RestLink/queryparameter.h>
 #include <RestLink/httputils.h>
 
@@ -21,26 +31,39 @@ namespace RestLink {
 namespace Sql {
 
 Router::Router(QObject *parent)
-    : RestLink::AbstractServerWorker(Synchronous, parent)
+    : RestLink::AbstractServerWorker(Asynchronous, parent)
+    , m_context(nullptr)
 {
 }
 
 Router::~Router()
 {
+    m_executor.waitForDone();
+    delete m_context;
 }
 
 bool Router::init()
 {
+    m_context = new QObject();
     return true;
 }
 
 void Router::cleanup()
 {
+    m_executor.waitForDone();
+
+    delete m_context;
+    m_context = nullptr;
+
     Api::cleanupApis();
 }
 
 bool Router::maintain()
 {
+    // Slow requests still running may use any API
+    if (m_pendingExecutions.loadRelaxed() > 0)
+        return true;
+
     if (Api::apiCount() >= 5)
         Api::purgeApis(1, true);
     else
@@ -68,6 +91,30 @@ void Router::processStandardRequest(const ServerRequest &request, ServerResponse
         }
     }
 
+    // Requests known to be slow don't hold the queue, others run right away
+    const QString key = latencyKey(request);
+    if (m_context && isDispatchable(request, api) && api->latencyStats()->isSlow(key, api->slowQueryThreshold())) {
+        dispatch(request, response, key, api);
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    void *source = acquireDataSource(request, api);
+    route(request, response, &m_defaultController, api);
+    releaseDataSource(source, api);
+
+    api->latencyStats()->record(key, timer.elapsed());
+}
+
+void Router::route(const ServerRequest &request, ServerResponse *response, ModelController *controller, Api *api)
+{
+    if (request.endpoint() == "/stats") {
+        processStatsRequest(request, response, api);
+        return;
+    }
+
     if (request.endpoint() == "/configuration") {
         processConfigurationRequest(request, response, api);
         return;
@@ -90,37 +137,170 @@ void Router::processStandardRequest(const ServerRequest &request, ServerResponse
         for (const QueryParameter &parameter : queryParameters)
             parameters.insert(parameter.name(), parameter.value());
 
-        const SqlQueryInfo query = endpoint.getQuery();
-        const QStringList queries = query.allFormated(parameters);
-
-        ServerRequest queryRequest(AbstractRequestHandler::PostMethod, request, queries.join(";\n"));
-        queryRequest.setEndpoint("/query");
-        queryRequest.addQueryParameter("object", query.isObjectQuery());
-        processQueryRequest(queryRequest, response, api);
+        processQueries(endpoint.getQuery().queries(parameters, api), endpoint, response, api);
         return;
     }
 
-    m_defaultController.init(request, api);
-    if (m_defaultController.canProcessRequest(request)) {
-        m_defaultController.processRequest(request, response);
+    controller->init(request, api);
+    if (controller->canProcessRequest(request)) {
+        controller->processRequest(request, response);
         return;
     }
 
     processUnsupportedRequest(request, response);
 }
 
+void Router::dispatch(const ServerRequest &request, ServerResponse *response, const QString &key, Api *api)
+{
+    struct Execution {
+        QPointer<ServerResponse> response;
+        QAtomicInt cancelled;
+        bool settled = false; // Router thread only
+    };
+
+    QSharedPointer<Execution> execution = QSharedPointer<Execution>::create();
+    execution->response = response;
+
+    // The response gets completed from the router thread, once the executor is done
+    response->defer();
+
+    // Aborted requests waiting for a thread are not executed at all
+    connect(response, &Response::networkErrorOccured, m_context, [execution] {
+        execution->cancelled.storeRelaxed(1);
+    }, Qt::DirectConnection);
+
+    // Only the client is answered on time. Drivers that can't stop a statement on the server
+    // (SQLite, ODBC...) keep it running, holding its connection and executor thread until it ends
+    const int timeout = api->queryTimeout();
+    if (timeout > 0) {
+        QTimer::singleShot(timeout, m_context, [execution] {
+            if (execution->settled)
+                return;
+
+            execution->settled = true;
+            execution->cancelled.storeRelaxed(1);
+
+            ServerResponse *response = execution->response;
+            if (!response || response->isFinished())
+                return;
+
+            response->setHttpStatusCode(504);
+            response->setBody(QJsonObject({ { "message", "query timed out" } }));
+            response->complete();
+        });
+    }
+
+    m_pendingExecutions.ref();
+
+    m_executor.start([this, execution, request, key, timeout, api] {
+        int status = 0;
+        QByteArray data;
+        QByteArray contentType;
+
+        if (!execution->cancelled.loadRelaxed()) {
+            QElapsedTimer timer;
+            timer.start();
+
+            // Results are staged, only the router thread touches the client's response
+            ServerResponse result(nullptr);
+            ModelController controller;
+
+            // The API is the one captured here, the API registry belongs to the router thread
+            void *source = acquireDataSource(request, api);
+            const bool limited = (timeout > 0 && DatabaseUtils::setStatementTimeout(timeout, api));
+            route(request, &result, &controller, api);
+
+            // The connection goes back to the pool, where other requests don't expect a limit
+            if (limited)
+                DatabaseUtils::setStatementTimeout(0, api);
+            releaseDataSource(source, api);
+
+            api->latencyStats()->record(key, timer.elapsed());
+
+            status = result.httpStatusCode();
+            contentType = result.header("Content-Type").toUtf8();
+            data = result.readBody();
+        }
+
+        QMetaObject::invokeMethod(m_context, [this, execution, status, data, contentType] {
+            m_pendingExecutions.deref();
+
+            if (execution->settled)
+                return;
+            execution->settled = true;
+
+            ServerResponse *response = execution->response;
+            if (!response || response->isFinished())
+                return;
+
+            response->setHttpStatusCode(status);
+            response->setBody(Body(data, contentType));
+            response->complete();
+        }, Qt::QueuedConnection);
+    });
+}
+
 void *Router::requestDataSource(const ServerRequest &request)
 {
-    Api *api = Api::api(request.baseUrl());
-    return (api ? new QSqlDatabase(api->database()) : nullptr);
+    return acquireDataSource(request, Api::api(request.baseUrl()));
 }
 
 void Router::clearDataSource(const ServerRequest &request, void *source)
 {
-    Q_UNUSED(request);
-
     if (source)
-        delete static_cast<QSqlDatabase *>(source);
+        releaseDataSource(source, Api::api(request.baseUrl()));
+}
+
+void *Router::acquireDataSource(const ServerRequest &request, Api *api)
+{
+    if (!api)
+        return nullptr;
+
+    // Reads may be served by a replica, writes always go to the primary
+    const Api::Access access = (request.method() == AbstractRequestHandler::GetMethod ? Api::ReadOnly : Api::ReadWrite);
+
+    // Clients are told apart by their credentials or session, anonymous ones share a key
+    QString client;
+    for (const QString &header : { QStringLiteral("Authorization"), QStringLiteral("Cookie") }) {
+        if (request.hasHeader(header)) {
+            client = header + ':' + request.headerValues(header).constFirst().toString();
+            break;
+        }
+    }
+
+    return new QSqlDatabase(api->acquireDatabase(access, client));
+}
+
+void Router::releaseDataSource(void *source, Api *api)
+{
+    if (!source)
+        return;
+
+    delete static_cast<QSqlDatabase *>(source);
+
+    if (api) {
+        // Transactions are over, results computed meanwhile must not stay cached
+        api->resultCache()->endWrites();
+        api->releaseDatabase();
+    }
+}
+
+void Router::processStatsRequest(const ServerRequest &request, ServerResponse *response, Api *api)
+{
+    if (request.method() != AbstractRequestHandler::GetMethod) {
+        processUnsupportedRequest(request, response);
+        return;
+    }
+
+    QJsonObject stats;
+    stats.insert("slow_threshold", api->slowQueryThreshold());
+    stats.insert("timeout", api->queryTimeout());
+    stats.insert("pending", m_pendingExecutions.loadRelaxed());
+    stats.insert("endpoints", api->latencyStats()->toJson());
+
+    response->setHttpStatusCode(200);
+    response->setBody(stats);
+    response->complete();
 }
 
 void Router::processConfigurationRequest(const ServerRequest &request, ServerResponse *response, Api *api)
@@ -172,40 +352,54 @@ void Router::processQueryRequest(const ServerRequest &request, ServerResponse *r
         return;
     }
 
-    QSqlQuery query(api->database());
-    query.setForwardOnly(true);
-
-    auto process = [&query, api](const QString &statement, bool singleResult, bool *success) -> QJsonObject {
+    auto process = [api](const QString &statement, bool singleResult, QByteArray *output) -> bool {
         Query query;
         query.statement = statement;
         query.array = !singleResult;
-        return QueryRunner::exec(query, api, success);
+        return QueryRunner::exec(query, api, output);
     };
 
     const QString input = request.body().toString().trimmed();
     const QStringList statements = QueryBuilder::statementsFromScript(input);
 
+    // stream=json or stream=ndjson sends rows as they are fetched
+    if (statements.size() == 1 && request.hasQueryParameter("stream")) {
+        const QString format = request.queryParameterValues("stream").constFirst().toString();
+
+        Query query;
+        query.statement = statements.constFirst();
+        processStreamedQuery(query, format == "ndjson", response, api);
+        return;
+    }
+
     bool forceObject = request.hasQueryParameter("object") && request.queryParameterValues("object").constFirst().toBool();
     if (statements.size() == 1 && forceObject) {
-        bool success;
-        response->setBody(process(statements.constFirst(), forceObject, &success));
+        QByteArray output;
+        const bool success = process(statements.constFirst(), forceObject, &output);
+        response->setBody(Body(output, RESTLINK_MIME_JSON));
         response->setHttpStatusCode(success ? 200 : 401);
         response->complete();
         return;
     }
 
-    if (statements.size() > 1) {
-        int successes = 0;
-        bool success;
+    // transaction=true runs the whole script atomically, on_error=stop|continue decides what a failure does
+    const bool transactional = request.hasQueryParameter("transaction") && request.queryParameterValues("transaction").constFirst().toBool();
+    if (statements.size() > 1 || transactional) {
+        ScriptRunner runner(api);
+        runner.setTransactional(transactional);
+        runner.setErrorMode(transactional ? ScriptRunner::StopOnError : ScriptRunner::ContinueOnError);
 
-        QJsonArray results;
-        for (const QString &statement : statements) {
-            results.append(process(statement, false, &success));
-            successes += (success ? 1 : 0);
+        if (request.hasQueryParameter("on_error")) {
+            const QString mode = request.queryParameterValues("on_error").constFirst().toString();
+            runner.setErrorMode(mode == "continue" ? ScriptRunner::ContinueOnError : ScriptRunner::StopOnError);
         }
 
-        response->setBody(results);
-        response->setHttpStatusCode(successes > 0 ? 200 : 500);
+        QByteArray output;
+        runner.run(statements, &output);
+
+        const bool success = runner.successCount() > 0 && (!transactional || runner.isCommitted());
+        response->setBody(Body(output, RESTLINK_MIME_JSON));
+        response->setHttpStatusCode(success ? 200 : 500);
         response->complete();
         return;
     }
@@ -214,5 +408,105 @@ void Router::processQueryRequest(const ServerRequest &request, ServerResponse *r
     response->complete();
 }
 
+void Router::processStreamedQuery(const Query &query, bool lines, ServerResponse *response, Api *api)
+{
+    response->setHttpStatusCode(200);
+    response->setBody(Body(QByteArray(), lines ? RESTLINK_MIME_NDJSON : RESTLINK_MIME_JSON));
+
+    QByteArray output;
+    const bool success = QueryRunner::exec(query, api, &output, [response](const QByteArray &chunk) {
+        return response->writeBody(chunk);
+    }, lines);
+
+    // Failures happen before any row is sent
+    if (success) {
+        response->writeBody(output);
+    } else {
+        response->setHttpStatusCode(500);
+        response->setBody(Body(output, RESTLINK_MIME_JSON));
+    }
+
+    response->complete();
+}
+
+void Router::processQueries(const QList<Query> &queries, const EndpointInfo &endpoint, ServerResponse *response, Api *api)
+{
+    ResultCache *cache = api->resultCache();
+    const ResultCachePolicy policy = endpoint.cachePolicy();
+
+    QByteArray key;
+    QStringList tables;
+    if (policy.isEnabled()) {
+        for (const Query &query : queries) {
+            key.append(ResultCache::keyOf(query.statement, query.values));
+            key.append('\n');
+            tables.append(ResultCache::tablesOf(query.statement));
+        }
+    }
+
+    QByteArray output;
+    if (!key.isEmpty() && cache->find(endpoint.name(), key, &output)) {
+        response->setBody(Body(output, RESTLINK_MIME_JSON));
+        response->setHttpStatusCode(200);
+        response->complete();
+        return;
+    }
+
+    const quint64 generation = cache->generation();
+    int successes = 0;
+
+    if (queries.size() == 1) {
+        successes += (QueryRunner::exec(queries.constFirst(), api, &output) ? 1 : 0);
+    } else {
+        output.append('[');
+        for (const Query &query : queries) {
+            if (output.size() > 1)
+                output.append(',');
+            successes += (QueryRunner::exec(query, api, &output) ? 1 : 0);
+        }
+        output.append(']');
+    }
+
+    // Partial failures are not worth keeping
+    if (!key.isEmpty() && successes == queries.size())
+        cache->insert(endpoint.name(), key, output, tables, policy, generation);
+
+    response->setBody(Body(output, RESTLINK_MIME_JSON));
+    response->setHttpStatusCode(successes > 0 ? 200 : 500);
+    response->complete();
+}
+
+QString Router::latencyKey(const ServerRequest &request)
+{
+    QString key = HttpUtils::verbString(request.method()) + QStringLiteral(" /") + request.resource();
+    if (request.identifier().isValid())
+        key.append(QStringLiteral("/{id}"));
+    return key;
+}
+
+bool Router::isDispatchable(const ServerRequest &request, Api *api)
+{
+    // Streamed bodies go straight to the client
+    if (request.hasQueryParameter("stream"))
+        return false;
+
+    // Executor threads need their own connection
+    if (api->connectionPool()->maximumSize() < 2)
+        return false;
+
+    // Writes keep their order, they stay on the router thread
+    if (request.method() == AbstractRequestHandler::GetMethod)
+        return true;
+
+    if (request.method() == AbstractRequestHandler::PostMethod && request.endpoint() == "/query") {
+        const QStringList statements = QueryBuilder::statementsFromScript(request.body().toString().trimmed());
+        return std::all_of(statements.begin(), statements.end(), [](const QString &statement) {
+            return ResultCache::isReadStatement(statement);
+        });
+    }
+
+    return false;
+}
+
 } // namespace Sql
 } // namespace RestLink
@@ -7,10 +7,16 @@
 
 #include <RestLink/abstractserverworker.h>
 
+#include <QtCore/qthreadpool.h>
+#include <QtCore/qatomic.h>
+
 namespace RestLink {
 namespace Sql {
 
-class SQL_EXPORT Router final : public RestLink::AbstractServerWorker
+class Query;
+class EndpointInfo;
+
+class SQL_EXPORT Router : public RestLink::AbstractServerWorker
 {
     Q_OBJECT
 
@@ -29,11 +35,27 @@ protected:
     void clearDataSource(const ServerRequest &request, void *source) override;
 
 private:
+    void route(const ServerRequest &request, ServerResponse *response, ModelController *controller, Api *api);
+    void dispatch(const ServerRequest &request, ServerResponse *response, const QString &key, Api *api);
+
+    void processStatsRequest(const ServerRequest &request, ServerResponse *response, Api *api);
     void processConfigurationRequest(const ServerRequest &request, ServerResponse *response, Api *api);
     void processDatabaseTablesRequest(const ServerRequest &request, ServerResponse *response, Api *api);
     void processQueryRequest(const ServerRequest &request, ServerResponse *response, Api *api);
+    void processStreamedQuery(const Query &query, bool lines, ServerResponse *response, Api *api);
+    void processQueries(const QList<Query> &queries, const EndpointInfo &endpoint, ServerResponse *response, Api *api);
+
+    static void *acquireDataSource(const ServerRequest &request, Api *api);
+    static void releaseDataSource(void *source, Api *api);
+
+    static QString latencyKey(const ServerRequest &request);
+    static bool isDispatchable(const ServerRequest &request, Api *api);
 
     ModelController m_defaultController;
+
+    QThreadPool m_executor; // Runs requests known to be slow
+    QObject *m_context; // Lives in the router thread, gets results back from the executor
+    QAtomicInt m_pendingExecutions;
 };
 
 } // namespace Sql
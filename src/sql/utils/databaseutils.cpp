@@ -2,28 +2,23 @@
 
 #include <api.h>
 
-#include <qsqlindex.h>
+#include <utils/schemacache.h>
+
+#include <QtSql/qsqlquery.h>
 
 namespace RestLink {
 namespace Sql {
 
 QString DatabaseUtils::primaryKeyOn(const QString &tableName, Api *api)
 {
-    QSqlDatabase db = api->database();
-
-    const QSqlIndex index = db.primaryIndex(tableName);
-    if (index.count() == 1)
-        return index.fieldName(0);
-
-    const QSqlRecord record = db.record(tableName);
-    return (record.count() > 0 ? record.fieldName(0) : QStringLiteral("id"));
+    return api->schema()->primaryKey(tableName, api);
 }
 
 QStringList DatabaseUtils::foreignKeysOn(const QString &tableName, Api *api)
 {
     QStringList keys;
 
-    const QSqlRecord record = api->database().record(tableName);
+    const QSqlRecord record = api->schema()->record(tableName, api);
     for (int i = 0; i < record.count(); ++i) {
         const QString field = record.fieldName(i);
         if (field.endsWith("_id"))
@@ -52,6 +47,22 @@ QString DatabaseUtils::singularise(const QString &tableName)
     return name;
 }
 
+bool DatabaseUtils::setStatementTimeout(int msecs, Api *api)
+{
+    const QSqlDatabase db = api->database();
+
+    // Only servers can stop a statement on their own, other drivers run it to the end
+    QString statement;
+    if (db.driverName() == "QPSQL")
+        statement = QStringLiteral("SET statement_timeout = %1");
+    else if (db.driverName() == "QMYSQL" || db.driverName() == "QMARIADB")
+        statement = QStringLiteral("SET SESSION max_execution_time = %1");
+    else
+        return false;
+
+    QSqlQuery query(db);
+    return query.exec(statement.arg(qMax(0, msecs)));
+}
 
 } // namespace Sql
 } // namespace RestLink
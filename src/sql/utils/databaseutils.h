@@ -17,6 +17,8 @@ public:
     static QString foreignKeyFor(const QString &tableName, Api *api);
 
     static QString singularise(const QString &tableName);
+
+    static bool setStatementTimeout(int msecs, Api *api);
 };
 
 } // namespace Sql
@@ -6,11 +6,15 @@
 #include <QtCore/qjsonobject.h>
 #include <QtCore/qjsonarray.h>
 #include <QtCore/qjsonvalue.h>
+#include <QtCore/qlocale.h>
 
 #include <QtSql/qsqlfield.h>
 #include <QtSql/qsqlquery.h>
 #include <QtSql/qsqldriver.h>
 
+// Streamed rows are handed out once this many bytes are written
+#define JSON_STREAM_CHUNK_SIZE (64 * 1024)
+
 namespace RestLink {
 namespace Sql {
 
@@ -28,14 +32,18 @@ QSqlRecord JsonUtils::recordFromObject(const QJsonObject &object, const Resource
 {
     QSqlRecord record;
     const QStringList fields = resource.fieldNames();
+    const QList<QMetaType> types = resource.fieldTypes();
+
+    for (int i(0); i < fields.size(); ++i) {
+        const QString &name = fields.at(i);
 
-    for (const QString &name : fields) {
-        if (!object.contains(name))
+        const auto it = object.constFind(name);
+        if (it == object.constEnd())
             continue;
 
-        QMetaType metaType = resource.fieldType(name);
+        const QMetaType metaType = types.at(i);
 
-        QVariant value = object.value(name).toVariant();
+        QVariant value = it.value().toVariant();
         if (metaType.isValid())
             value.convert(metaType);
 
@@ -111,5 +119,179 @@ QJsonObject JsonUtils::objectFromError(const QSqlError &error)
     return object;
 }
 
+void JsonUtils::writeObject(const QJsonObject &object, QByteArray *output)
+{
+    output->append(QJsonDocument(object).toJson(QJsonDocument::Compact));
+}
+
+void JsonUtils::writeValue(const QVariant &value, QByteArray *output)
+{
+    if (value.isNull()) {
+        output->append("null");
+        return;
+    }
+
+    switch (value.typeId()) {
+    case QMetaType::Bool:
+        output->append(value.toBool() ? "true" : "false");
+        break;
+
+    case QMetaType::Short:
+    case QMetaType::Int:
+    case QMetaType::Long:
+    case QMetaType::LongLong:
+        output->append(QByteArray::number(value.toLongLong()));
+        break;
+
+    case QMetaType::UShort:
+    case QMetaType::UInt:
+    case QMetaType::ULong:
+    case QMetaType::ULongLong:
+        output->append(QByteArray::number(value.toULongLong()));
+        break;
+
+    case QMetaType::Float:
+    case QMetaType::Double:
+    {
+        const double number = value.toDouble();
+        if (qIsFinite(number))
+            output->append(QByteArray::number(number, 'g', QLocale::FloatingPointShortest));
+        else
+            output->append("null");
+        break;
+    }
+
+    case QMetaType::QString:
+        writeString(value.toString(), output);
+        break;
+
+    default:
+        if (value.canConvert<QString>())
+            writeString(value.toString(), output);
+        else
+            output->append("null");
+        break;
+    }
+}
+
+void JsonUtils::writeString(const QString &string, QByteArray *output)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    const QByteArray utf8 = string.toUtf8();
+    const char *data = utf8.constData();
+    const qsizetype size = utf8.size();
+
+    output->append('"');
+
+    // Runs of characters that don't need escaping are copied at once
+    qsizetype start = 0;
+    for (qsizetype i(0); i < size; ++i) {
+        const uchar c = uchar(data[i]);
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+
+        output->append(data + start, i - start);
+        start = i + 1;
+
+        switch (c) {
+        case '"':  output->append("\\\""); break;
+        case '\\': output->append("\\\\"); break;
+        case '\b': output->append("\\b"); break;
+        case '\f': output->append("\\f"); break;
+        case '\n': output->append("\\n"); break;
+        case '\r': output->append("\\r"); break;
+        case '\t': output->append("\\t"); break;
+
+        default:
+            output->append("\\u00");
+            output->append(hex[c >> 4]);
+            output->append(hex[c & 0xf]);
+            break;
+        }
+    }
+
+    output->append(data + start, size - start);
+    output->append('"');
+}
+
+JsonRecordWriter::JsonRecordWriter(const QSqlRecord &record, const QStringList &hiddenFields)
+{
+    // Keys are escaped once, rows then only write values
+    for (int i(0); i < record.count(); ++i) {
+        const QString name = record.fieldName(i);
+        if (hiddenFields.contains(name))
+            continue;
+
+        QByteArray key;
+        JsonUtils::writeString(name, &key);
+        key.append(':');
+
+        m_columns.append(i);
+        m_keys.append(key);
+    }
+}
+
+void JsonRecordWriter::writeObject(const QSqlQuery &query, QByteArray *output) const
+{
+    output->append('{');
+
+    for (int i(0); i < m_columns.size(); ++i) {
+        if (i > 0)
+            output->append(',');
+        output->append(m_keys.at(i));
+
+        const int column = m_columns.at(i);
+        if (query.isNull(column))
+            output->append("null");
+        else
+            JsonUtils::writeValue(query.value(column), output);
+    }
+
+    output->append('}');
+}
+
+int JsonRecordWriter::writeArray(QSqlQuery *query, QByteArray *output, const Flush &flush) const
+{
+    int count = 0;
+
+    output->append('[');
+    while (query->next()) {
+        if (count++ > 0)
+            output->append(',');
+        writeObject(*query, output);
+
+        if (flush && output->size() >= JSON_STREAM_CHUNK_SIZE) {
+            const bool accepted = flush(*output);
+            output->clear();
+            if (!accepted)
+                break;
+        }
+    }
+    output->append(']');
+
+    return count;
+}
+
+int JsonRecordWriter::writeLines(QSqlQuery *query, QByteArray *output, const Flush &flush) const
+{
+    int count = 0;
+
+    while (query->next()) {
+        writeObject(*query, output);
+        output->append('\n');
+        ++count;
+
+        if (flush && output->size() >= JSON_STREAM_CHUNK_SIZE) {
+            const bool accepted = flush(*output);
+            output->clear();
+            if (!accepted)
+                break;
+        }
+    }
+
+    return count;
+}
+
 } // namespace Sql
 } // namespace RestLink
@@ -8,6 +8,8 @@
 #include <QtSql/qsqlrecord.h>
 #include <QtSql/qsqlerror.h>
 
+#include <functional>
+
 class QSqlQuery;
 
 namespace RestLink {
@@ -26,6 +28,26 @@ public:
 
     static QJsonObject objectFromQuery(const QSqlQuery &query);
     static QJsonObject objectFromError(const QSqlError &error);
+
+    static void writeObject(const QJsonObject &object, QByteArray *output);
+    static void writeValue(const QVariant &value, QByteArray *output);
+    static void writeString(const QString &string, QByteArray *output);
+};
+
+class SQL_EXPORT JsonRecordWriter
+{
+public:
+    JsonRecordWriter(const QSqlRecord &record, const QStringList &hiddenFields = QStringList());
+
+    typedef std::function<bool(const QByteArray &chunk)> Flush; // Returns false to stop writing
+
+    void writeObject(const QSqlQuery &query, QByteArray *output) const;
+    int writeArray(QSqlQuery *query, QByteArray *output, const Flush &flush = Flush()) const;
+    int writeLines(QSqlQuery *query, QByteArray *output, const Flush &flush = Flush()) const;
+
+private:
+    QList<int> m_columns;
+    QList<QByteArray> m_keys;
 };
 
 } // namespace Sql
@@ -0,0 +1,64 @@
+#include "latencystats.h"
+
+#include <QtCore/qjsonobject.h>
+
+// Weight of the latest sample in the moving average
+#define LATENCY_SMOOTHING 0.2
+
+namespace RestLink {
+namespace Sql {
+
+void LatencyStats::record(const QString &key, qint64 msecs)
+{
+    QMutexLocker locker(&m_mutex);
+
+    Entry &entry = m_entries[key];
+    if (entry.count++ == 0)
+        entry.average = msecs;
+    else
+        entry.average += (msecs - entry.average) * LATENCY_SMOOTHING;
+
+    entry.maximum = qMax(entry.maximum, msecs);
+    entry.last = msecs;
+}
+
+LatencyStats::Entry LatencyStats::entry(const QString &key) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.value(key);
+}
+
+bool LatencyStats::isSlow(const QString &key, int threshold) const
+{
+    if (threshold <= 0)
+        return false;
+
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_entries.constFind(key);
+    return it != m_entries.constEnd() && it->average >= threshold;
+}
+
+QJsonObject LatencyStats::toJson() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QJsonObject object;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        QJsonObject entry;
+        entry.insert("count", it->count);
+        entry.insert("average", qRound64(it->average));
+        entry.insert("maximum", it->maximum);
+        entry.insert("last", it->last);
+        object.insert(it.key(), entry);
+    }
+    return object;
+}
+
+void LatencyStats::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+}
+
+} // namespace Sql
+} // namespace RestLink
@@ -0,0 +1,39 @@
+#ifndef LATENCYSTATS_H
+#define LATENCYSTATS_H
+
+#include <global.h>
+
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+
+class QJsonObject;
+
+namespace RestLink {
+namespace Sql {
+
+class SQL_EXPORT LatencyStats final
+{
+public:
+    struct Entry {
+        qint64 count = 0;
+        double average = 0; // Milliseconds, recent requests weigh more
+        qint64 maximum = 0;
+        qint64 last = 0;
+    };
+
+    void record(const QString &key, qint64 msecs);
+    Entry entry(const QString &key) const;
+    bool isSlow(const QString &key, int threshold) const;
+
+    QJsonObject toJson() const;
+    void clear();
+
+private:
+    QHash<QString, Entry> m_entries;
+    mutable QMutex m_mutex;
+};
+
+} // namespace Sql
+} // namespace RestLink
+
+#endif // LATENCYSTATS_H
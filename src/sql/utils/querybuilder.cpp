@@ -10,6 +10,7 @@
 #include <QtSql/qsqldatabase.h>
 #include <QtSql/qsqldriver.h>
 #include <QtSql/qsqlfield.h>
+#include <QtSql/qsqlrecord.h>
 
 namespace RestLink {
 namespace Sql {
@@ -24,7 +25,8 @@ QString QueryBuilder::selectStatement(const ResourceInfo &resource, const QueryO
     if (!canGenerate(resource, options, api))
         return QString();
 
-    QString statement = QStringLiteral("SELECT * FROM %1").arg(formatTableName(resource.table(), api));
+    QString statement = QStringLiteral("%1 FROM %2")
+                            .arg(selectClause(resource, options, api), formatTableName(resource.table(), api));
 
     const QString whereClause = QueryBuilder::whereClause(options, api);
     if (!whereClause.isEmpty())
@@ -32,7 +34,7 @@ QString QueryBuilder::selectStatement(const ResourceInfo &resource, const QueryO
 
     if (!options.sortField.isEmpty()) {
         statement += QStringLiteral(" ORDER BY %1 %2")
-                         .arg(options.sortField,
+                         .arg(formatFieldName(options.sortField, api),
                               options.sortOrder == Qt::AscendingOrder ? "ASC" : "DESC");
     }
 
@@ -40,7 +42,7 @@ QString QueryBuilder::selectStatement(const ResourceInfo &resource, const QueryO
         statement.append(QStringLiteral(" LIMIT %1").arg(options.limit));
 
     if (options.offset > 0)
-        statement.append(QStringLiteral("OFFSET %1").arg(options.offset));
+        statement.append(QStringLiteral(" OFFSET %1").arg(options.offset));
 
     return statement;
 }
@@ -65,6 +67,90 @@ QString QueryBuilder::insertStatement(const ResourceInfo &resource, const QVaria
         .arg(formatTableName(table, api), columns.join(", "), values.join(", "));
 }
 
+QString QueryBuilder::insertStatement(const ResourceInfo &resource, const QStringList &fields, const QList<QVariantHash> &rows, ConflictMode mode, const QStringList &conflictFields, Api *api)
+{
+    if (!canGenerate(resource, QueryOptions(), api) || fields.isEmpty() || rows.isEmpty())
+        return QString();
+
+    const QSqlDatabase db = api->database();
+    const QSqlDriver *driver = db.driver();
+    const bool mysql = (db.driverName() == "QMYSQL" || db.driverName() == "QMARIADB");
+
+    QStringList columns;
+    QList<QMetaType> types;
+    for (const QString &field : fields) {
+        columns.append(driver->escapeIdentifier(field, QSqlDriver::FieldName));
+        types.append(resource.fieldType(field));
+    }
+
+    // All rows share the same columns, one tuple per row
+    QStringList tuples;
+    tuples.reserve(rows.size());
+
+    QStringList values(fields.size());
+    for (const QVariantHash &row : rows) {
+        for (int i(0); i < fields.size(); ++i) {
+            QSqlField field(QStringLiteral("x"), types.at(i));
+            field.setValue(row.value(fields.at(i)));
+            values[i] = driver->formatValue(field);
+        }
+        tuples.append('(' + values.join(", ") + ')');
+    }
+
+    QString statement = QStringLiteral("INSERT %1INTO %2 (%3) VALUES %4")
+                            .arg(mysql && mode == ConflictIgnore ? "IGNORE " : "",
+                                 formatTableName(resource.table(), api),
+                                 columns.join(", "),
+                                 tuples.join(", "));
+
+    if (mode == ConflictFail)
+        return statement;
+
+    // Updates need a conflict target, the primary key by default
+    QStringList targetFields = conflictFields;
+    if (mode == ConflictUpdate && targetFields.isEmpty() && !resource.primaryKey().isEmpty())
+        targetFields.append(resource.primaryKey());
+
+    // On conflict, every inserted column except keys and creation timestamp gets overwritten
+    QStringList updates;
+    if (mode == ConflictUpdate) {
+        for (int i(0); i < fields.size(); ++i) {
+            const QString &field = fields.at(i);
+            if (targetFields.contains(field) || field == resource.creationTimestampField())
+                continue;
+
+            const QString &column = columns.at(i);
+            updates.append(QStringLiteral("%1 = %2").arg(column, mysql ? "VALUES(" + column + ')' : "excluded." + column));
+        }
+    }
+
+    if (mysql) {
+        if (!updates.isEmpty())
+            statement.append(" ON DUPLICATE KEY UPDATE " + updates.join(", "));
+        return statement;
+    }
+
+    // DO UPDATE without a conflict target is a syntax error
+    if (!updates.isEmpty() && targetFields.isEmpty())
+        return QString();
+
+    statement.append(" ON CONFLICT");
+
+    if (!targetFields.isEmpty()) {
+        QStringList targets;
+        for (const QString &field : targetFields)
+            targets.append(driver->escapeIdentifier(field, QSqlDriver::FieldName));
+        statement.append(" (" + targets.join(", ") + ')');
+    }
+
+    if (updates.isEmpty())
+        statement.append(" DO NOTHING");
+    else
+        statement.append(" DO UPDATE SET " + updates.join(", "));
+
+    return statement;
+}
+
 QString QueryBuilder::updateStatement(const ResourceInfo &resource, const QVariantHash &data, const QueryOptions &options, Api *api)
 {
     if (!canGenerate(resource, options, api))
@@ -108,6 +194,26 @@ QString QueryBuilder::deleteStatement(const ResourceInfo &resource, const QueryO
         .arg(formatTableName(table, api), !whereClause.isEmpty() ? ' ' + whereClause : QString());
 }
 
+QString QueryBuilder::selectClause(const ResourceInfo &resource, const QueryOptions &options, Api *api)
+{
+    if (options.fields.isEmpty())
+        return QStringLiteral("SELECT *");
+
+    QStringList columns;
+    columns.reserve(options.fields.size());
+    for (const QString &field : options.fields) {
+        // Unknown columns are dropped, they can't be selected anyway
+        if (resource.isValid() && !resource.hasField(field))
+            continue;
+        columns.append(formatFieldName(field, api));
+    }
+
+    if (columns.isEmpty())
+        return QStringLiteral("SELECT *");
+
+    return QStringLiteral("SELECT ") + columns.join(", ");
+}
+
 void QueryBuilder::extract(const ResourceInfo &resource, const QVariantHash &data, QStringList *columns, QStringList *values, Api *api)
 {
     if (!canGenerate(resource, QueryOptions(), api))
@@ -142,7 +248,19 @@ QString QueryBuilder::whereClause(const QueryOptions &options, Api *api)
         QString expression;
         if (!filter.expression.isEmpty())
             expression = filter.expression;
-        else {
+        else if (filter.value.metaType() == QMetaType::fromType<QVariantList>()) {
+            const QVariantList values = filter.value.toList();
+
+            QStringList formatted;
+            for (const QVariant &value : values)
+                formatted.append(formatValue(value, value.metaType(), api));
+
+            // An empty list must match nothing, not be dropped
+            if (formatted.isEmpty())
+                expression = QStringLiteral("1 = 0");
+            else
+                expression = QStringLiteral("%1 %2 (%3)").arg(formatFieldName(filter.name, api), filter.op, formatted.join(", "));
+        } else {
             expression = QStringLiteral("%1 %3 %2")
                 .arg(formatFieldName(filter.name, api), formatValue(filter.value, filter.value.metaType(), api), filter.op);
         }
@@ -153,7 +271,7 @@ QString QueryBuilder::whereClause(const QueryOptions &options, Api *api)
         if (filters.isEmpty())
             filters.append(expression);
         else
-            filters.append(filter.inclusive ? "AND " : "OR " + expression);
+            filters.append((filter.inclusive ? "AND " : "OR ") + expression);
     }
 
     if (filters.isEmpty())
@@ -216,6 +334,9 @@ QStringList QueryBuilder::statementsFromScript(const QString &script)
             delimiter = line.trimmed();
         }
 
+        // Statements may span several lines
+        if (!statement.isEmpty())
+            statement.append(' ');
         statement.append(line);
 
         if (line.endsWith(delimiter)) {
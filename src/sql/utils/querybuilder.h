@@ -19,12 +19,21 @@ class QueryOptions;
 class SQL_EXPORT QueryBuilder
 {
 public:
+    enum ConflictMode {
+        ConflictFail,
+        ConflictIgnore,
+        ConflictUpdate
+    };
+
     static bool canGenerate(const ResourceInfo &resource, const QueryOptions &options, Api *api);
     static QString selectStatement(const ResourceInfo &resource, const QueryOptions &options, Api *api);
     static QString insertStatement(const ResourceInfo &resource, const QVariantHash &data, Api *api);
+    static QString insertStatement(const ResourceInfo &resource, const QStringList &fields, const QList<QVariantHash> &rows, ConflictMode mode, const QStringList &conflictFields, Api *api);
     static QString updateStatement(const ResourceInfo &resource, const QVariantHash &data, const QueryOptions &options, Api *api);
     static QString deleteStatement(const ResourceInfo &resource, const QueryOptions &options, Api *api);
 
+    static QString selectClause(const ResourceInfo &resource, const QueryOptions &options, Api *api);
+
     static void extract(const ResourceInfo &resource, const QVariantHash &data, QStringList *columns, QStringList *values, Api *api);
     static QString whereClause(const QueryOptions &options, Api *api);
 
@@ -52,6 +61,8 @@ public:
     { m_filters.append({ .inclusive = true, .name = name, .op = op, .value = value }); }
     void andWhere(const Expression &expr)
     { m_filters.append({ .expression = expr }); }
+    void andWhereIn(const QString &name, const QVariantList &values)
+    { m_filters.append({ .inclusive = true, .name = name, .op = "IN", .value = values }); }
 
     void orWhere(const QString &name, const QVariant &value)
     { orWhere(name, "=", value); }
@@ -60,6 +71,9 @@ public:
     void orWhere(const Expression &expr)
     { m_filters.append({ .inclusive = false, .expression = expr }); }
 
+    bool isEmpty() const
+    { return m_filters.isEmpty(); }
+
 
 private:
     struct Filter {
@@ -77,6 +91,7 @@ private:
 class QueryOptions
 {
 public:
+    QStringList fields; // Empty means all columns
     QueryFilters filters;
 
     QString sortField;
@@ -4,6 +4,7 @@
 #include <api.h>
 #include <meta/resourceinfo.h>
 #include <utils/jsonutils.h>
+#include <utils/resultcache.h>
 
 #include <QtCore/qjsonarray.h>
 
@@ -16,7 +17,7 @@ namespace Sql {
 QJsonObject QueryRunner::exec(const Query &query, Api *api, bool *success)
 {
     bool succeeded = false;
-    QSqlQuery sqlQuery = exec(query.statement, api, &succeeded);
+    QSqlQuery sqlQuery = exec(query.statement, query.values, api, &succeeded);
     if (!succeeded) {
         if (success) *success = false;
         return JsonUtils::objectFromQuery(sqlQuery);
@@ -39,7 +40,53 @@ QJsonObject QueryRunner::exec(const Query &query, Api *api, bool *success)
     return body;
 }
 
+bool QueryRunner::exec(const Query &query, Api *api, QByteArray *output)
+{
+    return exec(query, api, output, JsonRecordWriter::Flush());
+}
+
+bool QueryRunner::exec(const Query &query, Api *api, QByteArray *output, const JsonRecordWriter::Flush &flush, bool lines)
+{
+    bool succeeded = false;
+    QSqlQuery sqlQuery = exec(query.statement, query.values, api, &succeeded);
+
+    // Query metadata goes first, rows are then written straight from the query
+    const QJsonObject body = JsonUtils::objectFromQuery(sqlQuery);
+    if (!succeeded || !lines)
+        JsonUtils::writeObject(body, output);
+    if (!succeeded)
+        return false;
+
+    // One object per row, nothing else
+    if (lines) {
+        const JsonRecordWriter writer(sqlQuery.record());
+        writer.writeLines(&sqlQuery, output, flush);
+        return true;
+    }
+
+    output->chop(1);
+    if (!body.isEmpty())
+        output->append(',');
+    output->append("\"data\":");
+
+    const JsonRecordWriter writer(sqlQuery.record());
+    if (query.array)
+        writer.writeArray(&sqlQuery, output, flush);
+    else if (sqlQuery.next())
+        writer.writeObject(sqlQuery, output);
+    else
+        output->append("null");
+
+    output->append('}');
+    return true;
+}
+
 QSqlQuery QueryRunner::exec(const QString &statement, Api *api, bool *success)
+{
+    return exec(statement, QVariantList(), api, success);
+}
+
+QSqlQuery QueryRunner::exec(const QString &statement, const QVariantList &values, Api *api, bool *success)
 {
     if (statement.isEmpty()) {
         sqlWarning() << "Empty query detected !";
@@ -50,7 +97,22 @@ QSqlQuery QueryRunner::exec(const QString &statement, Api *api, bool *success)
 
     QSqlQuery sqlQuery(api->database());
     sqlQuery.setForwardOnly(true);
-    if (!sqlQuery.exec(statement)) {
+
+    bool executed;
+    if (values.isEmpty()) {
+        executed = sqlQuery.exec(statement);
+    } else {
+        executed = sqlQuery.prepare(statement);
+        for (const QVariant &value : values)
+            sqlQuery.addBindValue(value);
+        executed = executed && sqlQuery.exec();
+    }
+
+    // Cached results built on written tables are outdated
+    if (executed)
+        api->resultCache()->invalidateStatement(statement);
+
+    if (!executed) {
 #ifdef RESTLINK_DEBUG
         const QString error = sqlQuery.lastError().databaseText();
         sqlWarning() << error;
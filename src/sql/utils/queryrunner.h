@@ -3,6 +3,8 @@
 
 #include <global.h>
 
+#include <utils/jsonutils.h>
+
 #include <QtCore/qjsonobject.h>
 
 #include <QtSql/qsqlquery.h>
@@ -16,6 +18,7 @@ class SQL_EXPORT Query
 {
 public:
     QString statement;
+    QVariantList values; // Bound to positional placeholders
     bool array = true;
 };
 
@@ -23,7 +26,10 @@ class SQL_EXPORT QueryRunner
 {
 public:
     static QJsonObject exec(const Query &query, Api *api, bool *success = nullptr);
+    static bool exec(const Query &query, Api *api, QByteArray *output);
+    static bool exec(const Query &query, Api *api, QByteArray *output, const JsonRecordWriter::Flush &flush, bool lines = false);
     static QSqlQuery exec(const QString &statement, Api *api, bool *success = nullptr);
+    static QSqlQuery exec(const QString &statement, const QVariantList &values, Api *api, bool *success = nullptr);
 };
 
 } // namespace Sql
@@ -0,0 +1,205 @@
+#include "resultcache.h"
+
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qthread.h>
+#include <QtCore/qregularexpression.h>
+
+namespace RestLink {
+namespace Sql {
+
+bool ResultCachePolicy::isEnabled() const
+{
+    return ttl > 0 && maxSize > 0;
+}
+
+void ResultCachePolicy::load(const QJsonObject &object)
+{
+    ttl = object.value("ttl").toInt();
+    maxSize = object.value("max_size").toInteger();
+}
+
+void ResultCachePolicy::save(QJsonObject *object) const
+{
+    object->insert("ttl", ttl);
+    object->insert("max_size", maxSize);
+}
+
+ResultCache::ResultCache()
+    : m_generation(0)
+{
+}
+
+ResultCache::~ResultCache()
+{
+    qDeleteAll(m_partitions);
+}
+
+quint64 ResultCache::generation() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_generation;
+}
+
+bool ResultCache::find(const QString &owner, const QByteArray &key, QByteArray *data)
+{
+    QMutexLocker locker(&m_mutex);
+
+    QCache<QByteArray, Entry> *partition = m_partitions.value(owner);
+    if (!partition)
+        return false;
+
+    const Entry *entry = partition->object(key);
+    if (!entry)
+        return false;
+
+    if (entry->expiry < QDateTime::currentMSecsSinceEpoch()) {
+        partition->remove(key);
+        return false;
+    }
+
+    *data = entry->data;
+    return true;
+}
+
+void ResultCache::insert(const QString &owner, const QByteArray &key, const QByteArray &data, const QStringList &tables, const ResultCachePolicy &policy, quint64 generation)
+{
+    if (!policy.isEnabled() || data.size() > policy.maxSize)
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    // Something was written while the result was computed, it may already be outdated
+    if (generation != m_generation)
+        return;
+
+    QCache<QByteArray, Entry> *&partition = m_partitions[owner];
+    if (!partition)
+        partition = new QCache<QByteArray, Entry>();
+    partition->setMaxCost(policy.maxSize);
+
+    Entry *entry = new Entry;
+    entry->data = data;
+    entry->tables = tables;
+    entry->expiry = QDateTime::currentMSecsSinceEpoch() + qint64(policy.ttl) * 1000;
+    partition->insert(key, entry, data.size());
+}
+
+void ResultCache::invalidate(const QStringList &tables)
+{
+    QMutexLocker locker(&m_mutex);
+
+    // Tables are invalidated again once the request ends, after its transaction got committed
+    QSet<QString> &writes = m_writes[QThread::currentThread()];
+    for (const QString &table : tables)
+        writes.insert(table.toLower());
+
+    remove(tables);
+}
+
+void ResultCache::invalidateStatement(const QString &statement)
+{
+    if (isReadStatement(statement))
+        return;
+
+    const QStringList tables = tablesOf(statement);
+    if (!tables.isEmpty()) {
+        invalidate(tables);
+        return;
+    }
+
+    // Can't tell what was written
+    clear();
+}
+
+void ResultCache::endWrites()
+{
+    QMutexLocker locker(&m_mutex);
+
+    const QSet<QString> writes = m_writes.take(QThread::currentThread());
+    if (!writes.isEmpty())
+        remove(writes.values());
+}
+
+void ResultCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    qDeleteAll(m_partitions);
+    m_partitions.clear();
+    ++m_generation;
+}
+
+QByteArray ResultCache::keyOf(const QString &statement, const QVariantList &values)
+{
+    QByteArray key = statement.simplified().toUtf8();
+    for (const QVariant &value : values) {
+        key.append('\0');
+        key.append(value.metaType().name());
+        key.append(':');
+        key.append(value.toString().toUtf8());
+    }
+    return key;
+}
+
+QStringList ResultCache::tablesOf(const QString &statement)
+{
+    static const QRegularExpression expression(
+        QStringLiteral(R"(\b(?:FROM|JOIN|INTO|UPDATE|TABLE(?:\s+IF\s+(?:NOT\s+)?EXISTS)?)\s+)"
+                       R"(((?:[`"\[]?[\w.]+[`"\]]?(?:\s+(?:AS\s+)?\w+)?\s*,\s*)*[`"\[]?[\w.]+))"),
+        QRegularExpression::CaseInsensitiveOption);
+
+    QStringList tables;
+
+    QRegularExpressionMatchIterator it = expression.globalMatch(statement);
+    while (it.hasNext()) {
+        const QStringList names = it.next().captured(1).split(',');
+        for (const QString &name : names) {
+            QString table = name.trimmed().section(' ', 0, 0).toLower();
+            table.remove('`').remove('"').remove('[').remove(']');
+
+            if (!table.isEmpty() && !tables.contains(table))
+                tables.append(table);
+        }
+    }
+
+    return tables;
+}
+
+bool ResultCache::isReadStatement(const QString &statement)
+{
+    const QStringView view = QStringView(statement).trimmed();
+
+    qsizetype size = 0;
+    while (size < view.size() && view.at(size).isLetter())
+        ++size;
+
+    static const QStringList keywords = { "SELECT", "PRAGMA", "EXPLAIN", "SHOW" };
+    const QStringView keyword = view.left(size);
+    return std::any_of(keywords.begin(), keywords.end(), [&keyword](const QString &read) {
+        return keyword.compare(read, Qt::CaseInsensitive) == 0;
+    });
+}
+
+void ResultCache::remove(const QStringList &tables)
+{
+    ++m_generation;
+
+    for (QCache<QByteArray, Entry> *partition : std::as_const(m_partitions)) {
+        const QList<QByteArray> keys = partition->keys();
+        for (const QByteArray &key : keys) {
+            const Entry *entry = partition->object(key);
+            if (!entry)
+                continue;
+
+            const bool touched = std::any_of(tables.begin(), tables.end(), [entry](const QString &table) {
+                return entry->tables.contains(table, Qt::CaseInsensitive);
+            });
+
+            if (touched)
+                partition->remove(key);
+        }
+    }
+}
+
+} // namespace Sql
+} // namespace RestLink
@@ -0,0 +1,68 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include <global.h>
+
+#include <QtCore/qcache.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qset.h>
+#include <QtCore/qmutex.h>
+
+class QJsonObject;
+class QThread;
+
+namespace RestLink {
+namespace Sql {
+
+class SQL_EXPORT ResultCachePolicy
+{
+public:
+    bool isEnabled() const;
+
+    void load(const QJsonObject &object);
+    void save(QJsonObject *object) const;
+
+    int ttl = 0; // Seconds
+    qint64 maxSize = 0; // Bytes
+};
+
+class SQL_EXPORT ResultCache final
+{
+public:
+    ResultCache();
+    ~ResultCache();
+
+    quint64 generation() const;
+
+    bool find(const QString &owner, const QByteArray &key, QByteArray *data);
+    void insert(const QString &owner, const QByteArray &key, const QByteArray &data, const QStringList &tables, const ResultCachePolicy &policy, quint64 generation);
+
+    void invalidate(const QStringList &tables);
+    void invalidateStatement(const QString &statement);
+    void endWrites();
+    void clear();
+
+    static QByteArray keyOf(const QString &statement, const QVariantList &values = QVariantList());
+    static QStringList tablesOf(const QString &statement);
+    static bool isReadStatement(const QString &statement);
+
+private:
+    struct Entry {
+        QByteArray data;
+        QStringList tables;
+        qint64 expiry;
+    };
+
+    void remove(const QStringList &tables);
+
+    QHash<QString, QCache<QByteArray, Entry> *> m_partitions;
+    QHash<QThread *, QSet<QString>> m_writes; // Tables written by each thread's current request
+    quint64 m_generation;
+
+    mutable QMutex m_mutex;
+};
+
+} // namespace Sql
+} // namespace RestLink
+
+#endif // RESULTCACHE_H
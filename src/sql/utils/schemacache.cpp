@@ -0,0 +1,397 @@
+#include "schemacache.h"
+
+#include <api.h>
+#include <debug.h>
+
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qstandardpaths.h>
+#include <QtCore/qsavefile.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qdatetime.h>
+
+#include <QtSql/qsqlfield.h>
+#include <QtSql/qsqlindex.h>
+#include <QtSql/qsqlquery.h>
+
+#define SNAPSHOT_LIFETIME (60 * 60 * 1000)
+
+namespace RestLink {
+namespace Sql {
+
+SchemaCache::SchemaCache(const QUrl &url)
+    : m_url(url)
+    , m_checkedAt(0)
+    , m_hasTables(false)
+    , m_dirty(false)
+{
+    // In-memory databases don't survive restarts, neither should their schema
+    if (!(url.scheme() == "sqlite" && url.path().startsWith("memory"))) {
+        const QByteArray key = QCryptographicHash::hash(url.toString().toUtf8(), QCryptographicHash::Sha1).toHex();
+        const QString dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        if (!dir.isEmpty())
+            m_fileName = dir + QStringLiteral("/restlink/sql/") + QString::fromLatin1(key) + QStringLiteral(".json");
+    }
+}
+
+QString SchemaCache::fingerprint() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_fingerprint;
+}
+
+void SchemaCache::validate(const QString &current)
+{
+    const QString known = fingerprint();
+    if (known == current)
+        return;
+
+    // First use in this process, a snapshot from a previous run may still be valid
+    if (known.isEmpty() && load() && fingerprint() == current)
+        return;
+
+    QMutexLocker locker(&m_mutex);
+    clear();
+    m_fingerprint = current;
+    m_dirty = true;
+}
+
+void SchemaCache::refresh(Api *api, const QString &version)
+{
+    if (fingerprint().isEmpty())
+        load();
+
+    // Drivers only described table by table trust a recent snapshot, declared versions are always checked
+    const bool expiring = (version.isEmpty() && !describesStructure(api));
+    if (expiring) {
+        QMutexLocker locker(&m_mutex);
+        if (!m_fingerprint.isEmpty() && QDateTime::currentMSecsSinceEpoch() - m_checkedAt < SNAPSHOT_LIFETIME)
+            return;
+    }
+
+    validate(fingerprintOf(api, version));
+
+    if (expiring) {
+        QMutexLocker locker(&m_mutex);
+        m_checkedAt = QDateTime::currentMSecsSinceEpoch();
+        m_dirty = true;
+    }
+}
+
+QStringList SchemaCache::tables(Api *api)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_hasTables)
+            return m_tables;
+    }
+
+    const QStringList tables = api->database().tables();
+
+    QMutexLocker locker(&m_mutex);
+    m_tables = tables;
+    m_hasTables = true;
+    m_dirty = true;
+    return tables;
+}
+
+QSqlRecord SchemaCache::record(const QString &table, Api *api)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto it = m_tableInfos.constFind(table);
+        if (it != m_tableInfos.constEnd() && it->hasRecord)
+            return it->record;
+    }
+
+    const QSqlRecord record = api->database().record(table);
+
+    QMutexLocker locker(&m_mutex);
+    Table &info = m_tableInfos[table];
+    info.record = record;
+    info.hasRecord = true;
+    m_dirty = true;
+    return record;
+}
+
+QString SchemaCache::primaryKey(const QString &table, Api *api)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        const auto it = m_tableInfos.constFind(table);
+        if (it != m_tableInfos.constEnd() && it->hasPrimaryKey)
+            return it->primaryKey;
+    }
+
+    QString primaryKey;
+
+    const QSqlIndex index = api->database().primaryIndex(table);
+    if (index.count() == 1) {
+        primaryKey = index.fieldName(0);
+    } else {
+        const QSqlRecord record = this->record(table, api);
+        primaryKey = (record.count() > 0 ? record.fieldName(0) : QStringLiteral("id"));
+    }
+
+    QMutexLocker locker(&m_mutex);
+    Table &info = m_tableInfos[table];
+    info.primaryKey = primaryKey;
+    info.hasPrimaryKey = true;
+    m_dirty = true;
+    return primaryKey;
+}
+
+bool SchemaCache::isPersistent() const
+{
+    return !m_fileName.isEmpty();
+}
+
+bool SchemaCache::load()
+{
+    if (m_fileName.isEmpty())
+        return false;
+
+    QFile file(m_fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const QJsonObject object = QJsonDocument::fromJson(file.readAll()).object();
+    if (object.isEmpty())
+        return false;
+
+    fromJson(object);
+
+    QMutexLocker locker(&m_mutex);
+    m_dirty = false;
+    return true;
+}
+
+bool SchemaCache::save()
+{
+    if (m_fileName.isEmpty())
+        return false;
+
+    QJsonObject object;
+
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_dirty)
+            return true;
+    }
+
+    object = toJson();
+
+    QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+
+    QSaveFile file(m_fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        sqlWarning() << "Can't write schema cache " << m_fileName;
+        return false;
+    }
+
+    file.write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+    if (!file.commit())
+        return false;
+
+    QMutexLocker locker(&m_mutex);
+    m_dirty = false;
+    return true;
+}
+
+void SchemaCache::fromJson(const QJsonObject &object)
+{
+    QMutexLocker locker(&m_mutex);
+    clear();
+
+    m_fingerprint = object.value("fingerprint").toString();
+    m_checkedAt = object.value("checked_at").toInteger();
+
+    if (object.contains("tables")) {
+        const QJsonArray tables = object.value("tables").toArray();
+        for (const QJsonValue &table : tables)
+            m_tables.append(table.toString());
+        m_hasTables = true;
+    }
+
+    const QJsonObject schema = object.value("schema").toObject();
+    for (auto it = schema.begin(); it != schema.end(); ++it) {
+        const QJsonObject tableObject = it.value().toObject();
+
+        Table info;
+
+        if (tableObject.contains("primary_key")) {
+            info.primaryKey = tableObject.value("primary_key").toString();
+            info.hasPrimaryKey = true;
+        }
+
+        if (tableObject.contains("fields")) {
+            const QJsonArray fields = tableObject.value("fields").toArray();
+            for (const QJsonValue &value : fields) {
+                const QJsonObject fieldObject = value.toObject();
+
+                const QByteArray typeName = fieldObject.value("type").toString().toLatin1();
+                QSqlField field(fieldObject.value("name").toString(), QMetaType::fromName(typeName), it.key());
+                field.setRequired(fieldObject.value("required").toBool());
+                field.setAutoValue(fieldObject.value("auto_value").toBool());
+                info.record.append(field);
+            }
+            info.hasRecord = true;
+        }
+
+        m_tableInfos.insert(it.key(), info);
+    }
+}
+
+QJsonObject SchemaCache::toJson() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QJsonObject object;
+    object.insert("url", m_url.toString());
+    object.insert("fingerprint", m_fingerprint);
+    object.insert("checked_at", m_checkedAt);
+
+    if (m_hasTables)
+        object.insert("tables", QJsonArray::fromStringList(m_tables));
+
+    QJsonObject schema;
+    for (auto it = m_tableInfos.begin(); it != m_tableInfos.end(); ++it) {
+        const Table &info = it.value();
+
+        QJsonObject tableObject;
+        if (info.hasPrimaryKey)
+            tableObject.insert("primary_key", info.primaryKey);
+
+        if (info.hasRecord) {
+            QJsonArray fields;
+            for (int i(0); i < info.record.count(); ++i) {
+                const QSqlField field = info.record.field(i);
+
+                QJsonObject fieldObject;
+                fieldObject.insert("name", field.name());
+                fieldObject.insert("type", QString::fromLatin1(field.metaType().name()));
+                fieldObject.insert("required", field.requiredStatus() == QSqlField::Required);
+                fieldObject.insert("auto_value", field.isAutoValue());
+                fields.append(fieldObject);
+            }
+            tableObject.insert("fields", fields);
+        }
+
+        if (!tableObject.isEmpty())
+            schema.insert(it.key(), tableObject);
+    }
+    object.insert("schema", schema);
+
+    return object;
+}
+
+SchemaCache *SchemaCache::cache(const QUrl &url)
+{
+    // Credentials don't change the schema
+    const QUrl key = url.adjusted(QUrl::RemovePassword);
+
+    QMutexLocker locker(&s_mutex);
+
+    SchemaCache *cache = s_caches.value(key);
+    if (!cache) {
+        cache = new SchemaCache(key);
+        s_caches.insert(key, cache);
+    }
+    return cache;
+}
+
+void SchemaCache::cleanupCaches()
+{
+    QMutexLocker locker(&s_mutex);
+    qDeleteAll(s_caches);
+    s_caches.clear();
+}
+
+QString SchemaCache::fingerprintOf(Api *api, const QString &version)
+{
+    if (!version.isEmpty())
+        return QStringLiteral("version:") + version;
+
+    const QSqlDatabase db = api->database();
+
+    // SQLite increments its schema version on every schema change
+    if (db.driverName() == "QSQLITE") {
+        QSqlQuery query(db);
+        if (query.exec(QStringLiteral("PRAGMA schema_version")) && query.next())
+            return QStringLiteral("sqlite:") + query.value(0).toString();
+    }
+
+    return structureFingerprintOf(api);
+}
+
+QString SchemaCache::structureFingerprintOf(Api *api)
+{
+    const QSqlDatabase db = api->database();
+    const QString driver = db.driverName();
+
+    // Column changes must show up, not only table ones
+    QString statement;
+    if (driver == "QPSQL")
+        statement = QStringLiteral("SELECT table_name, column_name, data_type, is_nullable FROM information_schema.columns"
+                                   " WHERE table_schema = current_schema() ORDER BY table_name, ordinal_position");
+    else if (driver == "QMYSQL" || driver == "QMARIADB")
+        statement = QStringLiteral("SELECT table_name, column_name, data_type, is_nullable FROM information_schema.columns"
+                                   " WHERE table_schema = DATABASE() ORDER BY table_name, ordinal_position");
+
+    QByteArray structure;
+    bool described = false;
+
+    if (!statement.isEmpty()) {
+        QSqlQuery query(db);
+        if (query.exec(statement)) {
+            while (query.next()) {
+                for (int i(0); i < 4; ++i)
+                    structure.append(query.value(i).toString().toUtf8()).append('|');
+                structure.append('\n');
+            }
+            described = true;
+        }
+    }
+
+    // Other drivers get asked table by table
+    if (!described) {
+        QStringList tables = db.tables();
+        tables.sort();
+
+        for (const QString &table : std::as_const(tables)) {
+            const QSqlRecord record = db.record(table);
+            for (int i(0); i < record.count(); ++i) {
+                const QSqlField field = record.field(i);
+                structure.append(table.toUtf8()).append('|')
+                    .append(field.name().toUtf8()).append('|')
+                    .append(field.metaType().name()).append('|')
+                    .append(QByteArray::number(field.requiredStatus())).append('\n');
+            }
+        }
+    }
+
+    return QStringLiteral("columns:") + QString::fromLatin1(QCryptographicHash::hash(structure, QCryptographicHash::Sha1).toHex());
+}
+
+bool SchemaCache::describesStructure(Api *api)
+{
+    static const QStringList drivers = { "QSQLITE", "QPSQL", "QMYSQL", "QMARIADB" };
+    return drivers.contains(api->database().driverName());
+}
+
+void SchemaCache::clear()
+{
+    m_tables.clear();
+    m_hasTables = false;
+    m_tableInfos.clear();
+}
+
+QHash<QUrl, SchemaCache *> SchemaCache::s_caches;
+QMutex SchemaCache::s_mutex;
+
+} // namespace Sql
+} // namespace RestLink
@@ -0,0 +1,75 @@
+#ifndef SCHEMACACHE_H
+#define SCHEMACACHE_H
+
+#include <global.h>
+
+#include <QtCore/qurl.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+
+#include <QtSql/qsqlrecord.h>
+
+class QJsonObject;
+
+namespace RestLink {
+namespace Sql {
+
+class Api;
+
+class SQL_EXPORT SchemaCache final
+{
+public:
+    QString fingerprint() const;
+    void validate(const QString &current);
+    void refresh(Api *api, const QString &version = QString());
+
+    QStringList tables(Api *api);
+    QSqlRecord record(const QString &table, Api *api);
+    QString primaryKey(const QString &table, Api *api);
+
+    bool isPersistent() const;
+    bool load();
+    bool save();
+
+    void fromJson(const QJsonObject &object);
+    QJsonObject toJson() const;
+
+    static SchemaCache *cache(const QUrl &url);
+    static void cleanupCaches();
+
+    static QString fingerprintOf(Api *api, const QString &version = QString());
+    static QString structureFingerprintOf(Api *api);
+    static bool describesStructure(Api *api);
+
+private:
+    SchemaCache(const QUrl &url);
+
+    struct Table {
+        QSqlRecord record;
+        QString primaryKey;
+        bool hasRecord = false;
+        bool hasPrimaryKey = false;
+    };
+
+    void clear();
+
+    const QUrl m_url;
+    QString m_fileName;
+    QString m_fingerprint;
+    qint64 m_checkedAt; // When the fingerprint was last taken from the database
+
+    QStringList m_tables;
+    bool m_hasTables;
+    QHash<QString, Table> m_tableInfos;
+    bool m_dirty;
+
+    mutable QMutex m_mutex;
+
+    static QHash<QUrl, SchemaCache *> s_caches;
+    static QMutex s_mutex;
+};
+
+} // namespace Sql
+} // namespace RestLink
+
+#endif // SCHEMACACHE_H
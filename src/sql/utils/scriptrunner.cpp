@@ -0,0 +1,347 @@
+#include "scriptrunner.h"
+
+#include <debug.h>
+#include <api.h>
+#include <utils/jsonutils.h>
+#include <utils/resultcache.h>
+
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qregularexpression.h>
+
+#include <QtSql/qsqlerror.h>
+#include <QtSql/qsqlrecord.h>
+#include <QtSql/qsqldriver.h>
+
+#define SCRIPT_SAVEPOINT "restlink_statement"
+
+namespace RestLink {
+namespace Sql {
+
+ScriptRunner::ScriptRunner(Api *api)
+    : m_api(api)
+    , m_query(api->database())
+    , m_control(api->database())
+    , m_backslashEscapes(api->database().driver()->dbmsType() == QSqlDriver::MySqlServer)
+    , m_transactional(false)
+    , m_errorMode(ContinueOnError)
+    , m_successes(0)
+    , m_failures(0)
+    , m_committed(false)
+{
+    m_query.setForwardOnly(true);
+}
+
+bool ScriptRunner::isTransactional() const
+{
+    return m_transactional;
+}
+
+void ScriptRunner::setTransactional(bool transactional)
+{
+    m_transactional = transactional;
+}
+
+ScriptRunner::ErrorMode ScriptRunner::errorMode() const
+{
+    return m_errorMode;
+}
+
+void ScriptRunner::setErrorMode(ErrorMode mode)
+{
+    m_errorMode = mode;
+}
+
+bool ScriptRunner::run(const QStringList &statements, QByteArray *output)
+{
+    m_successes = 0;
+    m_failures = 0;
+    m_committed = false;
+
+    QSqlDatabase db = m_api->database();
+
+    bool transaction = false;
+    if (m_transactional) {
+        transaction = db.transaction();
+        if (!transaction)
+            sqlWarning() << "Can't start script transaction: " << db.lastError().text();
+    }
+
+    // Failed statements are undone alone, the transaction goes on
+    const bool savepoints = transaction && m_errorMode == ContinueOnError;
+
+    output->append('[');
+    for (const QString &statement : statements) {
+        if (output->size() > 1)
+            output->append(',');
+
+        if (savepoints)
+            execControl(QStringLiteral("SAVEPOINT " SCRIPT_SAVEPOINT));
+
+        QElapsedTimer timer;
+        timer.start();
+
+        const bool succeeded = exec(statement);
+        write(succeeded, timer.nsecsElapsed(), output);
+
+        if (succeeded) {
+            ++m_successes;
+            if (savepoints)
+                execControl(QStringLiteral("RELEASE SAVEPOINT " SCRIPT_SAVEPOINT));
+            continue;
+        }
+
+        ++m_failures;
+        if (savepoints) {
+            execControl(QStringLiteral("ROLLBACK TO SAVEPOINT " SCRIPT_SAVEPOINT));
+            execControl(QStringLiteral("RELEASE SAVEPOINT " SCRIPT_SAVEPOINT));
+        } else if (m_errorMode == StopOnError) {
+            break;
+        }
+    }
+    output->append(']');
+
+    if (!transaction)
+        return m_failures == 0;
+
+    m_query.finish();
+
+    if (m_errorMode == StopOnError && m_failures > 0) {
+        db.rollback();
+        return false;
+    }
+
+    m_committed = db.commit();
+    if (!m_committed) {
+        sqlWarning() << "Can't commit script transaction: " << db.lastError().text();
+        db.rollback();
+    }
+
+    return m_committed && m_failures == 0;
+}
+
+int ScriptRunner::successCount() const
+{
+    return m_successes;
+}
+
+int ScriptRunner::failureCount() const
+{
+    return m_failures;
+}
+
+bool ScriptRunner::isCommitted() const
+{
+    return m_committed;
+}
+
+QString ScriptRunner::shapeOf(const QString &statement, QVariantList *values, bool backslashEscapes)
+{
+    // Literals become positional placeholders, statements we can't safely rewrite get no shape
+
+    // Literals of queries and definitions may stand where placeholders aren't allowed
+    static const QStringList keywords = { "INSERT", "UPDATE", "DELETE", "REPLACE" };
+    const QStringView view = QStringView(statement).trimmed();
+    const bool writing = std::any_of(keywords.begin(), keywords.end(), [&view](const QString &keyword) {
+        return view.startsWith(keyword, Qt::CaseInsensitive)
+               && (view.size() == keyword.size() || view.at(keyword.size()).isSpace());
+    });
+
+    if (!writing)
+        return QString();
+
+    auto isIdentifier = [](QChar c) {
+        return c.isLetterOrNumber() || c == '_' || c == '$';
+    };
+
+    // Strings following any other word are typed literals, like DATE '2024-01-01', or aliases
+    static const QStringList valueKeywords = {
+        "VALUES", "SET", "WHERE", "AND", "OR", "NOT", "LIKE", "ILIKE", "IN", "IS", "CASE", "WHEN",
+        "THEN", "ELSE", "BETWEEN", "ESCAPE", "ON", "HAVING", "SELECT", "DISTINCT", "RETURNING"
+    };
+
+    auto followsType = [&isIdentifier](const QString &shape) {
+        qsizetype end = shape.size();
+        while (end > 0 && shape.at(end - 1).isSpace())
+            --end;
+
+        qsizetype start = end;
+        while (start > 0 && isIdentifier(shape.at(start - 1)))
+            --start;
+
+        const QStringView word = QStringView(shape).mid(start, end - start);
+        if (word.isEmpty() || word.front().isDigit())
+            return false;
+
+        return std::none_of(valueKeywords.begin(), valueKeywords.end(), [&word](const QString &keyword) {
+            return word.compare(keyword, Qt::CaseInsensitive) == 0;
+        });
+    };
+
+    // Numbers in these clauses may be column positions, which placeholders can't stand for
+    static const QRegularExpression ordering(R"(\b(ORDER|GROUP)\s+BY\b)", QRegularExpression::CaseInsensitiveOption);
+
+    const qsizetype size = view.size();
+
+    QString shape;
+    shape.reserve(size);
+
+    qsizetype i = 0;
+    while (i < size) {
+        const QChar c = view.at(i);
+        const QChar previous = (i > 0 ? view.at(i - 1) : QChar());
+        const QChar next = (i + 1 < size ? view.at(i + 1) : QChar());
+
+        // Strings, doubled quotes being escaped ones
+        if (c == '\'') {
+            // X'..', E'..' and the like are not plain strings
+            if (isIdentifier(previous))
+                return QString();
+
+            const qsizetype start = i;
+            QString value;
+            bool closed = false;
+            for (++i; i < size; ++i) {
+                // Escaping rules we can't be sure of, the server may or may not apply them
+                if (backslashEscapes && view.at(i) == '\\')
+                    return QString();
+
+                if (view.at(i) != '\'') {
+                    value.append(view.at(i));
+                } else if (i + 1 < size && view.at(i + 1) == '\'') {
+                    value.append('\'');
+                    ++i;
+                } else {
+                    closed = true;
+                    ++i;
+                    break;
+                }
+            }
+
+            if (!closed)
+                return QString();
+
+            // Typed literals can't be placeholders, they stay as they are
+            if (followsType(shape)) {
+                shape.append(view.mid(start, i - start));
+                continue;
+            }
+
+            values->append(value);
+            shape.append('?');
+            continue;
+        }
+
+        // Quoted identifiers are kept as they are
+        if (c == '"' || c == '`' || c == '[') {
+            const QChar end = (c == '[' ? QChar(']') : c);
+            const qsizetype last = view.indexOf(end, i + 1);
+            if (last < 0)
+                return QString();
+
+            shape.append(view.mid(i, last - i + 1));
+            i = last + 1;
+            continue;
+        }
+
+        // Already parameterized or commented, we don't touch it
+        if (c == '?' || (c == ':' && next.isLetter() && previous != ':')
+            || (c == '-' && next == '-') || (c == '/' && next == '*'))
+            return QString();
+
+        // Numbers, unless part of an identifier
+        if (c.isDigit() && !isIdentifier(previous) && previous != '.') {
+            qsizetype end = i;
+            while (end < size && (view.at(end).isDigit() || view.at(end) == '.'))
+                ++end;
+
+            if (end < size && isIdentifier(view.at(end)))
+                return QString();
+
+            if (shape.contains(ordering))
+                return QString();
+
+            const QStringView number = view.mid(i, end - i);
+
+            bool ok = false;
+            if (number.contains('.'))
+                values->append(number.toDouble(&ok));
+            else
+                values->append(number.toLongLong(&ok));
+
+            if (!ok)
+                return QString();
+
+            shape.append('?');
+            i = end;
+            continue;
+        }
+
+        shape.append(c);
+        ++i;
+    }
+
+    return (values->isEmpty() ? QString() : shape);
+}
+
+bool ScriptRunner::exec(const QString &statement)
+{
+    sqlInfo() << statement;
+
+    QVariantList values;
+    const QString shape = shapeOf(statement, &values, m_backslashEscapes);
+
+    // Statements sharing a shape reuse the prepared one
+    const bool reused = (!shape.isEmpty() && shape == m_shape);
+
+    bool executed = false;
+    if (!shape.isEmpty() && (reused || m_query.prepare(shape))) {
+        m_shape = shape;
+        for (int i(0); i < values.size(); ++i)
+            m_query.bindValue(i, values.at(i));
+        executed = m_query.exec();
+    } else {
+        m_shape.clear();
+        executed = m_query.exec(statement);
+    }
+
+    // Tables written by a reused shape were already invalidated
+    if (executed && !reused)
+        m_api->resultCache()->invalidateStatement(statement);
+
+#ifdef RESTLINK_DEBUG
+    if (!executed)
+        sqlWarning() << m_query.lastError().databaseText();
+#endif
+
+    return executed;
+}
+
+bool ScriptRunner::execControl(const QString &statement)
+{
+    if (m_control.exec(statement))
+        return true;
+
+    sqlWarning() << statement << ": " << m_control.lastError().text();
+    return false;
+}
+
+void ScriptRunner::write(bool succeeded, qint64 nsecs, QByteArray *output)
+{
+    QJsonObject body = JsonUtils::objectFromQuery(m_query);
+    body.insert("duration_ms", nsecs / 1000000.0);
+    JsonUtils::writeObject(body, output);
+
+    if (!succeeded || !m_query.isSelect())
+        return;
+
+    output->chop(1);
+    output->append(",\"data\":");
+
+    const JsonRecordWriter writer(m_query.record());
+    writer.writeArray(&m_query, output);
+
+    output->append('}');
+}
+
+} // namespace Sql
+} // namespace RestLink
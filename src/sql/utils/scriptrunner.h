@@ -0,0 +1,61 @@
+#ifndef SCRIPTRUNNER_H
+#define SCRIPTRUNNER_H
+
+#include <global.h>
+
+#include <QtCore/qvariant.h>
+
+#include <QtSql/qsqlquery.h>
+
+namespace RestLink {
+namespace Sql {
+
+class Api;
+
+class SQL_EXPORT ScriptRunner final
+{
+public:
+    enum ErrorMode {
+        StopOnError,
+        ContinueOnError
+    };
+
+    explicit ScriptRunner(Api *api);
+
+    bool isTransactional() const;
+    void setTransactional(bool transactional);
+
+    ErrorMode errorMode() const;
+    void setErrorMode(ErrorMode mode);
+
+    bool run(const QStringList &statements, QByteArray *output);
+
+    int successCount() const;
+    int failureCount() const;
+    bool isCommitted() const;
+
+    static QString shapeOf(const QString &statement, QVariantList *values, bool backslashEscapes = false);
+
+private:
+    bool exec(const QString &statement);
+    bool execControl(const QString &statement);
+    void write(bool succeeded, qint64 nsecs, QByteArray *output);
+
+    Api *m_api;
+    QSqlQuery m_query;
+    QSqlQuery m_control; // Savepoints, kept apart from the prepared statement
+    QString m_shape; // Statement currently prepared on m_query
+    bool m_backslashEscapes; // MySQL string literals
+
+    bool m_transactional;
+    ErrorMode m_errorMode;
+
+    int m_successes;
+    int m_failures;
+    bool m_committed;
+};
+
+} // namespace Sql
+} // namespace RestLink
+
+#endif // SCRIPTRUNNER_H
@@ -0,0 +1,29 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <gtest/gtest.h>
+
+#include <QtCore/qelapsedtimer.h>
+
+#include <iostream>
+
+// Runs fn() iterations times and reports the mean cost per call
+template<typename Fn>
+double benchmark(const char *name, int iterations, Fn &&fn)
+{
+    // Warm-up, so that lazy initializations don't count
+    for (int i(0); i < qMax(1, iterations / 10); ++i)
+        fn();
+
+    QElapsedTimer timer;
+    timer.start();
+    for (int i(0); i < iterations; ++i)
+        fn();
+    const double nsPerCall = double(timer.nsecsElapsed()) / iterations;
+
+    std::cout << "[ BENCHMARK] " << name << ": " << nsPerCall << " ns/call (" << iterations << " iterations)" << std::endl;
+    testing::Test::RecordProperty(name, QByteArray::number(nsPerCall, 'f', 1).toStdString());
+    return nsPerCall;
+}
+
+#endif // BENCHMARK_H
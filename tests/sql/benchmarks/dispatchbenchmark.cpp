@@ -0,0 +1,77 @@
+#include "dispatchbenchmark.h"
+#include "benchmark.h"
+
+#include <meta/endpointinfo.h>
+#include <meta/resourceinfo.h>
+
+#include <RestLink/request.h>
+#include <RestLink/serverresponse.h>
+#include <RestLink/body.h>
+
+using namespace RestLink;
+
+ServerRequest DispatchBenchmark::request(const QString &endpoint) const
+{
+    Request request(endpoint);
+    request.setBaseUrl(api->url());
+    return ServerRequest(AbstractRequestHandler::GetMethod, request, Body());
+}
+
+TEST_F(DispatchBenchmark, ApiLookup)
+{
+    const QUrl url = api->url();
+    benchmark("Api::api", 100000, [&url] {
+        Api *found = Api::api(url);
+        Q_UNUSED(found);
+    });
+
+    EXPECT_EQ(Api::api(url), api);
+}
+
+TEST_F(DispatchBenchmark, ResourceLookup)
+{
+    benchmark("Api::resourceInfoByTable", 100000, [this] {
+        const ResourceInfo resource = api->resourceInfoByTable("Products");
+        Q_UNUSED(resource);
+    });
+
+    benchmark("Api::endpointInfo", 100000, [this] {
+        const EndpointInfo endpoint = api->endpointInfo("/products");
+        Q_UNUSED(endpoint);
+    });
+
+    EXPECT_EQ(api->resourceInfoByTable("Products").name().toStdString(), "products");
+}
+
+TEST_F(DispatchBenchmark, FieldLookup)
+{
+    const ResourceInfo resource = api->resourceInfo("products");
+    const QStringList fields = resource.fieldNames();
+    ASSERT_FALSE(fields.isEmpty());
+
+    benchmark("ResourceInfo::fieldType", 100000, [&resource, &fields] {
+        for (const QString &field : fields)
+            resource.fieldType(field);
+    });
+
+    EXPECT_TRUE(resource.fieldType(fields.constLast()).isValid());
+    EXPECT_FALSE(resource.fieldType("unknown").isValid());
+}
+
+TEST_F(DispatchBenchmark, StandardRequest)
+{
+    AbstractServerWorker &worker = router;
+    const ServerRequest show = request("/products/1");
+
+    SqlLog::disableLogging();
+    benchmark("Router::processStandardRequest", 2000, [&worker, &show] {
+        ServerResponse response(nullptr);
+        worker.processStandardRequest(show, &response);
+    });
+    SqlLog::enableLogging();
+
+    ServerResponse response(nullptr);
+    worker.processStandardRequest(show, &response);
+    EXPECT_TRUE(response.isFinished());
+    EXPECT_EQ(response.httpStatusCode(), 200);
+}
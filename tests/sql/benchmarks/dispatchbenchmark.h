@@ -0,0 +1,22 @@
+#ifndef DISPATCHBENCHMARK_H
+#define DISPATCHBENCHMARK_H
+
+#include "common/sqltest.h"
+
+#include <routing/router.h>
+
+#include <RestLink/serverrequest.h>
+
+using namespace RestLink::Sql;
+
+class DispatchBenchmark : public SqlTest
+{
+protected:
+    DispatchBenchmark() : SqlTest(1) {}
+
+    RestLink::ServerRequest request(const QString &endpoint) const;
+
+    Router router;
+};
+
+#endif // DISPATCHBENCHMARK_H
@@ -0,0 +1,47 @@
+#include "modelbenchmark.h"
+#include "benchmark.h"
+
+#include <data/model.h>
+#include <utils/jsonutils.h>
+
+#include <QtCore/qjsonobject.h>
+
+#include <QtSql/qsqlrecord.h>
+
+static QJsonObject productObject(int index)
+{
+    QJsonObject object;
+    object.insert("id", index);
+    object.insert("name", QStringLiteral("Product %1").arg(index));
+    object.insert("description", "Imported");
+    object.insert("price", index * 0.5);
+    object.insert("barcode", QString::number(1000000000000 + index));
+    object.insert("category_id", index % 10);
+    object.insert("unknown", true);
+    return object;
+}
+
+TEST_F(ModelBenchmark, Fill)
+{
+    const QJsonObject object = productObject(1);
+
+    benchmark("Model::fill (full)", 100000, [this, &object] {
+        Model model(products, api);
+        model.fill(object);
+    });
+
+    benchmark("Model::fill (normal)", 100000, [this, &object] {
+        Model model(products, api);
+        model.fill(object, Model::NormalFill);
+    });
+}
+
+TEST_F(ModelBenchmark, RecordFromObject)
+{
+    const QJsonObject object = productObject(1);
+
+    benchmark("JsonUtils::recordFromObject", 100000, [this, &object] {
+        const QSqlRecord record = JsonUtils::recordFromObject(object, products);
+        Q_UNUSED(record);
+    });
+}
@@ -0,0 +1,18 @@
+#ifndef MODELBENCHMARK_H
+#define MODELBENCHMARK_H
+
+#include "common/sqltest.h"
+
+#include <meta/resourceinfo.h>
+
+using namespace RestLink::Sql;
+
+class ModelBenchmark : public SqlTest
+{
+protected:
+    ModelBenchmark() : SqlTest(1) {}
+
+    ResourceInfo products = api->resourceInfo("products");
+};
+
+#endif // MODELBENCHMARK_H
@@ -0,0 +1,104 @@
+#include "requestbenchmark.h"
+#include "benchmark.h"
+
+#include <RestLink/header.h>
+#include <RestLink/queryparameter.h>
+
+#include <QtCore/qhash.h>
+
+using namespace RestLink;
+
+Request RequestBenchmark::request(int count, const QString &prefix)
+{
+    Request request("/products");
+    for (int i(0); i < count; ++i) {
+        request.setHeader(QStringLiteral("X-%1-Header-%2").arg(prefix).arg(i), i);
+        request.addQueryParameter(QStringLiteral("%1_param_%2").arg(prefix).arg(i), i);
+    }
+    return request;
+}
+
+TEST_P(RequestBenchmark, HeaderLookup)
+{
+    const int count = GetParam();
+    const Request request = RequestBenchmark::request(count, "Api");
+    const QString last = QStringLiteral("x-api-header-%1").arg(count - 1);
+    const QByteArray suffix = '(' + QByteArray::number(count) + ')';
+
+    benchmark(("Request::header(last)" + suffix).constData(), 100000, [&request, &last] {
+        const Header header = request.header(last);
+        Q_UNUSED(header);
+    });
+
+    benchmark(("Request::hasHeader(missing)" + suffix).constData(), 100000, [&request] {
+        request.hasHeader("X-Missing");
+    });
+
+    benchmark(("Request::hasHeader(well known, missing)" + suffix).constData(), 100000, [&request] {
+        request.hasHeader("Content-Type");
+    });
+
+    // Baselines: the scan without hashes, and the index the hashes stand in for
+    const QList<Header> headers = request.headers();
+    benchmark(("scan by name(last)" + suffix).constData(), 100000, [&headers, &last] {
+        auto it = std::find_if(headers.cbegin(), headers.cend(), [&last](const Header &header) {
+            return header.name().compare(last, Qt::CaseInsensitive) == 0;
+        });
+        Q_UNUSED(it);
+    });
+
+    QHash<QString, qsizetype> index;
+    for (qsizetype i(0); i < headers.size(); ++i)
+        index.insert(headers.at(i).name().toLower(), i);
+    benchmark(("QHash index(last)" + suffix).constData(), 100000, [&index, &last] {
+        const qsizetype i = index.value(last.toLower(), -1);
+        Q_UNUSED(i);
+    });
+
+    EXPECT_EQ(request.header(last).value().toInt(), count - 1);
+    EXPECT_FALSE(request.hasHeader("X-Missing"));
+}
+
+TEST_P(RequestBenchmark, QueryParameterLookup)
+{
+    const int count = GetParam();
+    const Request request = RequestBenchmark::request(count, "api");
+    const QString last = QStringLiteral("api_param_%1").arg(count - 1);
+    const QByteArray suffix = '(' + QByteArray::number(count) + ')';
+
+    benchmark(("Request::queryParameter(last)" + suffix).constData(), 100000, [&request, &last] {
+        const QueryParameter parameter = request.queryParameter(last);
+        Q_UNUSED(parameter);
+    });
+
+    benchmark(("Request::hasQueryParameter(missing)" + suffix).constData(), 100000, [&request] {
+        request.hasQueryParameter("missing");
+    });
+
+    EXPECT_TRUE(request.hasQueryParameter(last));
+}
+
+TEST_P(RequestBenchmark, Merge)
+{
+    // What ApiBase::send() does with each request: merge the api parameters into it
+    const int count = GetParam();
+    const Request api = RequestBenchmark::request(count, "Api");
+    const Request caller = RequestBenchmark::request(count, "Caller");
+    const QByteArray suffix = '(' + QByteArray::number(count) + ')';
+
+    benchmark(("Request::merge(copy)" + suffix).constData(), 10000, [&api, &caller] {
+        const Request merged = Request::merge(caller, api);
+        Q_UNUSED(merged);
+    });
+
+    benchmark(("Request::merge(moved)" + suffix).constData(), 10000, [&api] {
+        const Request merged = Request::merge(Request("/products"), api);
+        Q_UNUSED(merged);
+    });
+
+    const Request merged = Request::merge(caller, api);
+    EXPECT_EQ(merged.headers().size(), 2 * count);
+    EXPECT_EQ(merged.queryParameters().size(), 2 * count);
+}
+
+INSTANTIATE_TEST_SUITE_P(Sizes, RequestBenchmark, testing::Values(4, 16, 64));
@@ -0,0 +1,15 @@
+#ifndef REQUESTBENCHMARK_H
+#define REQUESTBENCHMARK_H
+
+#include <gtest/gtest.h>
+
+#include <RestLink/request.h>
+
+// Requests holding a typical number of headers and query parameters, and a lot more
+class RequestBenchmark : public testing::TestWithParam<int>
+{
+protected:
+    static RestLink::Request request(int count, const QString &prefix);
+};
+
+#endif // REQUESTBENCHMARK_H
@@ -0,0 +1,100 @@
+#include "routingbenchmark.h"
+#include "benchmark.h"
+
+#include <RestLink/request.h>
+#include <RestLink/body.h>
+#include <RestLink/response.h>
+#include <RestLink/serverresponse.h>
+#include <RestLink/pluginmanager.h>
+
+using namespace RestLink;
+
+QStringList BenchmarkHandler::supportedSchemes() const
+{
+    return { "benchmark" };
+}
+
+AbstractRequestHandler::HandlerType BenchmarkHandler::handlerType() const
+{
+    return ServerHandler;
+}
+
+Response *BenchmarkHandler::sendRequest(Method method, const Request &request, const Body &body)
+{
+    Q_UNUSED(body);
+    ServerResponse *response = new ServerResponse(nullptr);
+    initResponse(response, request, method);
+    response->setMethod(method);
+    response->setHttpStatusCode(200);
+    response->complete();
+    return response;
+}
+
+void RoutingBenchmark::SetUp()
+{
+    PluginManager::registerHandler(&handler);
+}
+
+void RoutingBenchmark::TearDown()
+{
+    PluginManager::unregisterHandler(&handler);
+}
+
+TEST_F(RoutingBenchmark, NetworkScheme)
+{
+    const Request request(QUrl("http://127.0.0.1:9/products"));
+    benchmark("NetworkManager::route(http)", 100000, [this, &request] {
+        manager.route(request.baseUrl().scheme());
+    });
+
+    benchmark("NetworkManager::isRequestSupported(http)", 100000, [this, &request] {
+        manager.isRequestSupported(request);
+    });
+
+    // Replies are aborted right away, only building and routing them is measured
+    benchmark("NetworkManager::send(http)", 2000, [this, &request] {
+        Response *response = manager.send(AbstractRequestHandler::GetMethod, request, Body());
+        response->abort();
+        delete response;
+    });
+
+    EXPECT_EQ(manager.route("http"), &manager);
+}
+
+TEST_F(RoutingBenchmark, PluginScheme)
+{
+    const Request request(QUrl("benchmark://localhost/products"));
+    benchmark("NetworkManager::route(plugin)", 100000, [this, &request] {
+        manager.route(request.baseUrl().scheme());
+    });
+
+    benchmark("NetworkManager::isRequestSupported(plugin)", 100000, [this, &request] {
+        manager.isRequestSupported(request);
+    });
+
+    benchmark("NetworkManager::send(plugin)", 100000, [this, &request] {
+        Response *response = manager.send(AbstractRequestHandler::GetMethod, request, Body());
+        delete response;
+    });
+
+    EXPECT_EQ(manager.route("benchmark"), &handler);
+    Response *response = manager.send(AbstractRequestHandler::GetMethod, request, Body());
+    ASSERT_NE(response, nullptr);
+    EXPECT_EQ(response->httpStatusCode(), 200);
+    delete response;
+}
+
+TEST_F(RoutingBenchmark, UnknownScheme)
+{
+    benchmark("NetworkManager::route(unknown)", 100000, [this] {
+        manager.route("unknown");
+    });
+
+    benchmark("NetworkManager::supportedSchemes", 100000, [this] {
+        const QStringList schemes = manager.supportedSchemes();
+        Q_UNUSED(schemes);
+    });
+
+    EXPECT_EQ(manager.route("unknown"), nullptr);
+    EXPECT_TRUE(manager.supportedSchemes().contains("http"));
+}
@@ -0,0 +1,37 @@
+#ifndef ROUTINGBENCHMARK_H
+#define ROUTINGBENCHMARK_H
+
+#include <gtest/gtest.h>
+
+#include <RestLink/networkmanager.h>
+
+// Exposes the routing table used by sendRequest()
+class RoutingManager : public RestLink::NetworkManager
+{
+public:
+    using RestLink::NetworkManager::route;
+    using RestLink::NetworkManager::isRequestSupported;
+};
+
+// In-process handler answering right away, only the dispatch cost remains
+class BenchmarkHandler : public RestLink::AbstractRequestHandler
+{
+public:
+    QStringList supportedSchemes() const override;
+    HandlerType handlerType() const override;
+
+protected:
+    RestLink::Response *sendRequest(Method method, const RestLink::Request &request, const RestLink::Body &body) override;
+};
+
+class RoutingBenchmark : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    RoutingManager manager;
+    BenchmarkHandler handler;
+};
+
+#endif // ROUTINGBENCHMARK_H
@@ -0,0 +1,236 @@
+#include "connectionpooltest.h"
+
+#include <QtCore/qelapsedtimer.h>
+
+#include <QtSql/qsqlquery.h>
+
+#define POOL_CONNECTION "ConnectionPoolTest"
+
+using namespace RestLink;
+using namespace RestLink::Sql;
+
+void ConnectionPoolTest::SetUp()
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", POOL_CONNECTION);
+    db.setDatabaseName(":memory:");
+
+    pool = new ConnectionPool(POOL_CONNECTION);
+}
+
+void ConnectionPoolTest::TearDown()
+{
+    joinThreads();
+
+    delete pool;
+    pool = nullptr;
+    QSqlDatabase::removeDatabase(POOL_CONNECTION);
+
+    SqlTest::TearDown();
+}
+
+QThread *ConnectionPoolTest::startThread(const std::function<void ()> &function)
+{
+    QThread *thread = QThread::create(function);
+    thread->start();
+    threads.append(thread);
+    return thread;
+}
+
+void ConnectionPoolTest::joinThreads()
+{
+    for (QThread *thread : std::as_const(threads)) {
+        thread->wait();
+        delete thread;
+    }
+    threads.clear();
+}
+
+TEST_F(ConnectionPoolTest, GivesEachThreadItsOwnConnection)
+{
+    pool->setMaximumSize(3);
+
+    QSemaphore acquired;
+    QSemaphore done;
+    QStringList names(2);
+
+    for (int i(0); i < 2; ++i) {
+        startThread([&, i] {
+            const QSqlDatabase db = pool->acquire();
+            names[i] = db.connectionName();
+
+            // Nested acquisitions reuse the thread's connection
+            EXPECT_EQ(pool->acquire().connectionName(), names.at(i));
+            pool->release();
+
+            QSqlQuery query(db);
+            EXPECT_TRUE(query.exec("SELECT 1"));
+
+            acquired.release();
+            done.acquire();
+            pool->release();
+        });
+    }
+
+    acquired.acquire(2);
+    EXPECT_EQ(pool->size(), 3);
+    EXPECT_EQ(pool->idleCount(), 1);
+    EXPECT_NE(names.at(0), names.at(1));
+    EXPECT_FALSE(names.contains(POOL_CONNECTION));
+
+    done.release(2);
+    joinThreads();
+    EXPECT_EQ(pool->idleCount(), pool->size());
+}
+
+TEST_F(ConnectionPoolTest, TimesOutWhenFull)
+{
+    pool->setMaximumSize(2);
+
+    QSemaphore acquired;
+    QSemaphore done;
+
+    startThread([&] {
+        EXPECT_TRUE(pool->acquire().isValid());
+        acquired.release();
+        done.acquire();
+        pool->release();
+    });
+    acquired.acquire();
+
+    startThread([&] {
+        QElapsedTimer timer;
+        timer.start();
+        EXPECT_FALSE(pool->acquire(100).isValid());
+        EXPECT_GE(timer.elapsed(), 90);
+        EXPECT_EQ(pool->size(), 2);
+    })->wait();
+
+    done.release();
+}
+
+TEST_F(ConnectionPoolTest, WaitsForReleasedConnection)
+{
+    pool->setMaximumSize(2);
+
+    QSemaphore acquired;
+    QSemaphore done;
+    QString holder;
+
+    startThread([&] {
+        holder = pool->acquire().connectionName();
+        acquired.release();
+        done.acquire();
+        pool->release();
+    });
+    acquired.acquire();
+
+    QString waiter;
+    QThread *thread = startThread([&] {
+        const QSqlDatabase db = pool->acquire(5000);
+        waiter = db.connectionName();
+        pool->release();
+    });
+
+    // The holder gives its slot back to the waiting thread
+    QThread::msleep(100);
+    done.release();
+    thread->wait();
+
+    EXPECT_FALSE(waiter.isEmpty());
+    EXPECT_NE(waiter, holder);
+    EXPECT_FALSE(QSqlDatabase::contains(holder));
+    EXPECT_LE(pool->size(), 2);
+}
+
+TEST_F(ConnectionPoolTest, KeepsDatabaseConnectionWhileOthersWait)
+{
+    pool->setMaximumSize(2);
+
+    QSemaphore acquired;
+    QSemaphore done;
+
+    startThread([&] {
+        EXPECT_TRUE(pool->acquire().isValid());
+        acquired.release();
+        done.acquire();
+        pool->release();
+    });
+    acquired.acquire();
+
+    bool waited = false;
+    startThread([&] {
+        waited = pool->acquire(5000).isValid();
+        pool->release();
+    });
+
+    // Makes room for one more connection while a thread is still waiting
+    QThread::msleep(100);
+    pool->setMaximumSize(3);
+
+    startThread([&] {
+        const QSqlDatabase db = pool->database();
+        ASSERT_TRUE(db.isValid());
+        EXPECT_TRUE(QSqlDatabase::contains(db.connectionName()));
+        EXPECT_EQ(pool->database().connectionName(), db.connectionName());
+
+        QSqlQuery query(db);
+        EXPECT_TRUE(query.exec("SELECT 1"));
+    })->wait();
+
+    done.release();
+    joinThreads();
+    EXPECT_TRUE(waited);
+}
+
+TEST_F(ConnectionPoolTest, EvictsIdleConnectionsDownToMinimumSize)
+{
+    pool->setMaximumSize(4);
+    pool->setMinimumSize(2);
+    pool->setMaximumIdleTime(0);
+
+    for (int i(0); i < 3; ++i) {
+        startThread([&] {
+            EXPECT_TRUE(pool->acquire().isValid());
+            pool->release();
+        });
+    }
+
+    // Connections of finished threads can be closed from any thread
+    joinThreads();
+    EXPECT_EQ(pool->size(), 4);
+
+    EXPECT_EQ(pool->evictIdleConnections(), 2);
+    EXPECT_EQ(pool->size(), 2);
+
+    // Connections in use are never evicted
+    EXPECT_TRUE(pool->acquire().isValid());
+    EXPECT_EQ(pool->evictIdleConnections(true), 1);
+    EXPECT_EQ(pool->size(), 1);
+    pool->release();
+
+    // The template is only closed, it doesn't count as evicted
+    EXPECT_EQ(pool->evictIdleConnections(true), 0);
+    EXPECT_EQ(pool->size(), 1);
+}
+
+TEST_F(ConnectionPoolTest, ChecksIdleConnectionsBeforeHandingThemOut)
+{
+    pool->setHealthCheckInterval(0);
+
+    startThread([&] {
+        QSqlDatabase db = pool->acquire();
+        ASSERT_TRUE(db.isOpen());
+        pool->release();
+
+        // The connection got closed while idle, the health check reopens it
+        db.close();
+        QThread::msleep(10);
+
+        db = pool->acquire();
+        EXPECT_TRUE(db.isOpen());
+
+        QSqlQuery query(db);
+        EXPECT_TRUE(query.exec("SELECT 1"));
+        pool->release();
+    })->wait();
+}
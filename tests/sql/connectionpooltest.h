@@ -0,0 +1,26 @@
+#ifndef CONNECTIONPOOLTEST_H
+#define CONNECTIONPOOLTEST_H
+
+#include "common/sqltest.h"
+
+#include <connectionpool.h>
+
+#include <QtCore/qthread.h>
+#include <QtCore/qsemaphore.h>
+
+#include <functional>
+
+class ConnectionPoolTest : public SqlTest
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    QThread *startThread(const std::function<void ()> &function);
+    void joinThreads();
+
+    ConnectionPool *pool = nullptr;
+    QList<QThread *> threads;
+};
+
+#endif // CONNECTIONPOOLTEST_H
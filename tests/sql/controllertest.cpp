@@ -0,0 +1,113 @@
+#include "controllertest.h"
+
+#include <routing/modelcontroller.h>
+
+#include <RestLink/serverrequest.h>
+#include <RestLink/serverresponse.h>
+
+#include <QtCore/qjsonobject.h>
+#include <QtCore/qjsonarray.h>
+
+using namespace RestLink;
+
+ControllerTest::Reply ControllerTest::send(AbstractRequestHandler::Method method, const Request &request, const Body &body)
+{
+    const ServerRequest serverRequest(method, request, body);
+    ServerResponse response(nullptr);
+
+    ModelController controller;
+    controller.init(serverRequest, api);
+    if (controller.canProcessRequest(serverRequest))
+        controller.processRequest(serverRequest, &response);
+
+    Reply reply;
+    reply.status = response.httpStatusCode();
+
+    QJsonParseError error;
+    reply.body = response.readJson(&error);
+    return reply;
+}
+
+ControllerTest::Reply ControllerTest::get(const QString &endpoint, const QList<QPair<QString, QString>> &parameters)
+{
+    Request request(endpoint);
+    for (const QPair<QString, QString> &parameter : parameters)
+        request.addQueryParameter(parameter.first, parameter.second);
+    return send(AbstractRequestHandler::GetMethod, request);
+}
+
+TEST_F(ControllerTest, FiltersAndSortsFromQueryParameters)
+{
+    const Reply reply = get("/products", { { "filter[price][lt]", "1" }, { "sort", "-price" } });
+    ASSERT_EQ(reply.status, 200);
+
+    const QJsonArray data = reply.body.toObject().value("data").toArray();
+    ASSERT_EQ(data.size(), 2);
+    EXPECT_EQ(data.at(0).toObject().value("name").toString().toStdString(), "Apple");
+    EXPECT_EQ(data.at(1).toObject().value("name").toString().toStdString(), "Banana");
+}
+
+TEST_F(ControllerTest, ParsesInFilters)
+{
+    const Reply reply = get("/products", { { "filter[id][in]", "1,3" } });
+    ASSERT_EQ(reply.status, 200);
+
+    const QJsonArray data = reply.body.toObject().value("data").toArray();
+    ASSERT_EQ(data.size(), 2);
+    EXPECT_EQ(data.at(1).toObject().value("name").toString().toStdString(), "Milk");
+}
+
+TEST_F(ControllerTest, IgnoresUnrelatedParameters)
+{
+    const Reply reply = get("/products", { { "filterMode", "strict" }, { "filter[name]", "Milk" } });
+    ASSERT_EQ(reply.status, 200);
+    EXPECT_EQ(reply.body.toObject().value("data").toArray().size(), 1);
+}
+
+TEST_F(ControllerTest, RejectsInvalidFilters)
+{
+    EXPECT_EQ(get("/products", { { "filter[name", "x" } }).status, 400);
+    EXPECT_EQ(get("/products", { { "filter[unknown]", "x" } }).status, 400);
+    EXPECT_EQ(get("/products", { { "filter[name][regex]", "x" } }).status, 400);
+    EXPECT_EQ(get("/products", { { "filter[id]", "abc" } }).status, 400);
+    EXPECT_EQ(get("/products", { { "sort", "unknown" } }).status, 400);
+}
+
+TEST_F(ControllerTest, RejectsHiddenFields)
+{
+    // Foreign keys are hidden by default
+    ASSERT_TRUE(api->resourceInfo("products").hiddenFields().contains("category_id"));
+
+    const Reply filtered = get("/products", { { "filter[category_id][like]", "1%" } });
+    EXPECT_EQ(filtered.status, 400);
+    EXPECT_TRUE(filtered.body.toObject().contains("message"));
+
+    EXPECT_EQ(get("/products", { { "sort", "-category_id" } }).status, 400);
+}
+
+TEST_F(ControllerTest, RejectsUnknownConflictKeys)
+{
+    Request request("/products");
+    request.addQueryParameter("on_conflict", "update");
+    request.addQueryParameter("conflict_keys", "id,unknown");
+
+    const QJsonArray rows = { QJsonObject({ { "id", 1 }, { "name", "Green apple" }, { "price", 0.6 } }) };
+    const Reply reply = send(AbstractRequestHandler::PostMethod, request, Body(rows));
+    EXPECT_EQ(reply.status, 400);
+    EXPECT_TRUE(reply.body.toObject().contains("message"));
+
+    // Without keys, updates fall back to the primary key
+    request.removeQueryParameter("conflict_keys");
+    EXPECT_EQ(send(AbstractRequestHandler::PostMethod, request, Body(rows)).status, 200);
+}
+
+TEST_F(ControllerTest, RejectsInvalidIdentifiers)
+{
+    Request request("/products");
+    request.addQueryParameter("ids", "1,abc");
+    EXPECT_EQ(send(AbstractRequestHandler::DeleteMethod, request).status, 400);
+    EXPECT_EQ(send(AbstractRequestHandler::PatchMethod, request, Body(QJsonObject({ { "price", 1 } }))).status, 400);
+
+    // Nothing was touched
+    EXPECT_EQ(get("/products", { { "filter[id]", "1" } }).body.toObject().value("data").toArray().size(), 1);
+}
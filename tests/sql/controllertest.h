@@ -0,0 +1,25 @@
+#ifndef CONTROLLERTEST_H
+#define CONTROLLERTEST_H
+
+#include "common/sqltest.h"
+
+#include <RestLink/request.h>
+#include <RestLink/body.h>
+#include <RestLink/abstractrequesthandler.h>
+
+#include <QtCore/qjsonvalue.h>
+
+class ControllerTest : public SqlTest
+{
+protected:
+    struct Reply {
+        int status = 0;
+        QJsonValue body;
+    };
+
+    // Runs the request through ModelController, the way the router does
+    Reply send(RestLink::AbstractRequestHandler::Method method, const RestLink::Request &request, const RestLink::Body &body = RestLink::Body());
+    Reply get(const QString &endpoint, const QList<QPair<QString, QString>> &parameters = {});
+};
+
+#endif // CONTROLLERTEST_H
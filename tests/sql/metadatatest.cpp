@@ -4,7 +4,14 @@
 #include <meta/sqlqueryinfo.h>
 #include <meta/resourceinfo.h>
 
+#include <utils/queryrunner.h>
+#include <utils/schemacache.h>
+#include <utils/latencystats.h>
+
 #include <QtCore/qfile.h>
+#include <QtCore/qjsonarray.h>
+
+#include <QtSql/qsqlfield.h>
 
 TEST_F(MetadataTest, SuccessfulFinalConfigurationSaving)
 {
@@ -161,3 +168,221 @@ TEST_F(MetadataTest, RetrievesValidPivotResource)
     EXPECT_EQ(fields.at(1).toStdString(), "sale_id");
     EXPECT_EQ(fields.count(), 5);
 }
+
+TEST_F(MetadataTest, RestoresSchemaSnapshot)
+{
+    SchemaCache *schema = api->schema();
+    const QSqlRecord record = schema->record("Products", api);
+    ASSERT_FALSE(record.isEmpty());
+    EXPECT_EQ(schema->primaryKey("Products", api).toStdString(), "id");
+
+    // Restored snapshots are used without asking the database again
+    const QJsonObject snapshot = schema->toJson();
+    schema->fromJson(snapshot);
+
+    const QSqlRecord restored = schema->record("Products", api);
+    ASSERT_EQ(restored.count(), record.count());
+    for (int i(0); i < record.count(); ++i) {
+        EXPECT_EQ(restored.fieldName(i).toStdString(), record.fieldName(i).toStdString());
+        EXPECT_EQ(restored.field(i).metaType(), record.field(i).metaType());
+    }
+    EXPECT_EQ(schema->primaryKey("Products", api).toStdString(), "id");
+    EXPECT_EQ(schema->fingerprint().toStdString(), snapshot.value("fingerprint").toString().toStdString());
+}
+
+TEST_F(MetadataTest, InvalidatesSchemaOnColumnChanges)
+{
+    SchemaCache *schema = api->schema();
+    const int columns = schema->record("Products", api).count();
+    ASSERT_GT(columns, 0);
+
+    const QString fingerprint = SchemaCache::fingerprintOf(api);
+    const QString structure = SchemaCache::structureFingerprintOf(api);
+    EXPECT_EQ(SchemaCache::structureFingerprintOf(api), structure);
+
+    // The table list stays the same, only a column gets added
+    bool success = false;
+    QueryRunner::exec("ALTER TABLE Products ADD COLUMN stock INTEGER", api, &success);
+    ASSERT_TRUE(success);
+
+    EXPECT_NE(SchemaCache::fingerprintOf(api), fingerprint);
+    EXPECT_NE(SchemaCache::structureFingerprintOf(api), structure);
+
+    // SQLite tells its schema version, a recent snapshot isn't trusted over it
+    ASSERT_TRUE(SchemaCache::describesStructure(api));
+    schema->refresh(api);
+    const QSqlRecord record = schema->record("Products", api);
+    EXPECT_EQ(record.count(), columns + 1);
+    EXPECT_TRUE(record.contains("stock"));
+}
+
+TEST_F(MetadataTest, CompilesQueryInfoWithBoundParameters)
+{
+    const SqlQueryInfo query = api->endpointInfo("/products-categories").getQuery();
+
+    QVariantHash data;
+    data.insert("page", "2");
+
+    const QList<Query> queries = query.queries(data);
+    ASSERT_EQ(queries.count(), 2);
+    EXPECT_EQ(queries.at(0).statement.toStdString(), R"(SELECT * FROM Products LIMIT 10 OFFSET (? - 1) * 10)");
+    EXPECT_EQ(queries.at(1).statement.toStdString(), R"(SELECT * FROM Categories LIMIT 10 OFFSET (? - 1) * 10)");
+
+    // Request values take the type of the configured defaults
+    ASSERT_EQ(queries.at(0).values.count(), 1);
+    EXPECT_EQ(queries.at(0).values.at(0).toInt(), 2);
+    EXPECT_NE(queries.at(0).values.at(0).typeId(), QMetaType::QString);
+
+    // Defaults are bound when the request doesn't provide a value
+    const QList<Query> defaults = query.queries(QVariantHash());
+    ASSERT_EQ(defaults.count(), 2);
+    EXPECT_EQ(defaults.at(1).values.at(0).toInt(), 1);
+
+    bool success = false;
+    QueryRunner::exec(queries.at(0), api, &success);
+    EXPECT_TRUE(success);
+}
+
+TEST_F(MetadataTest, BindsQuotedPlaceholders)
+{
+    QJsonObject object;
+    object.insert("statement", "SELECT * FROM Products WHERE name = '{{name}}' OR name LIKE '%{{name}}%'");
+
+    SqlQueryInfo query;
+    query.load(object);
+
+    const QList<Query> queries = query.queries({ { "name", "it's" } }, api);
+    ASSERT_EQ(queries.count(), 1);
+    EXPECT_EQ(queries.at(0).statement.toStdString(), R"(SELECT * FROM Products WHERE name = ? OR name LIKE ('%' || ? || '%'))");
+    ASSERT_EQ(queries.at(0).values.count(), 2);
+    EXPECT_EQ(queries.at(0).values.at(0).toString().toStdString(), "it's");
+    EXPECT_EQ(queries.at(0).values.at(1).toString().toStdString(), "it's");
+
+    // Nothing from the request reaches the statement text
+    const QList<Query> injected = query.queries({ { "name", "\\' OR 1=1 --" } }, api);
+    EXPECT_EQ(injected.at(0).statement.toStdString(), queries.at(0).statement.toStdString());
+
+    bool success = false;
+    QueryRunner::exec(injected.at(0), api, &success);
+    EXPECT_TRUE(success);
+}
+
+TEST_F(MetadataTest, BindsQuotedPlaceholdersAsText)
+{
+    QJsonObject object;
+    object.insert("statement", "SELECT * FROM Products WHERE code = '{{code}}' LIMIT {{limit}}");
+
+    SqlQueryInfo query;
+    query.load(object);
+
+    const QList<Query> queries = query.queries({ { "code", "007" }, { "limit", "10" } });
+    ASSERT_EQ(queries.count(), 1);
+    ASSERT_EQ(queries.at(0).values.count(), 2);
+
+    // Leading zeros survive in quoted placeholders, bare ones still get a type
+    EXPECT_EQ(queries.at(0).values.at(0).typeId(), QMetaType::QString);
+    EXPECT_EQ(queries.at(0).values.at(0).toString().toStdString(), "007");
+    EXPECT_EQ(queries.at(0).values.at(1).typeId(), QMetaType::LongLong);
+}
+
+TEST_F(MetadataTest, RejectsPlaceholdersInDoubleQuotes)
+{
+    QJsonObject object;
+    object.insert("statement", R"(SELECT * FROM Products WHERE name = "{{name}}")");
+
+    SqlQueryInfo query;
+    query.load(object);
+
+    EXPECT_FALSE(query.isValid());
+    EXPECT_TRUE(query.queries({ { "name", "x" } }).isEmpty());
+}
+
+TEST_F(MetadataTest, RoutesReadsToReplicas)
+{
+    QJsonObject replicas;
+    replicas.insert("urls", QJsonArray({ "sqlite:memory/replica_1", "sqlite:memory/replica_2" }));
+    replicas.insert("stickiness", 60);
+
+    QJsonObject configuration = api->configuration();
+    configuration.insert("replicas", replicas);
+    api->configure(configuration);
+    ASSERT_EQ(api->replicaUrls().size(), 2);
+
+    // Round robin over replicas
+    const QString primary = api->database().connectionName();
+    QStringList names;
+    for (int i(0); i < 2; ++i) {
+        names.append(api->acquireDatabase(Api::ReadOnly).connectionName());
+        EXPECT_EQ(api->database().connectionName(), names.constLast());
+        api->releaseDatabase();
+    }
+    EXPECT_NE(names.at(0), primary);
+    EXPECT_NE(names.at(1), primary);
+    EXPECT_NE(names.at(0), names.at(1));
+
+    // Read-your-writes: reads following a write stay on the primary
+    EXPECT_EQ(api->acquireDatabase(Api::ReadWrite, "alice").connectionName(), primary);
+    api->releaseDatabase();
+    EXPECT_EQ(api->acquireDatabase(Api::ReadOnly, "alice").connectionName(), primary);
+    api->releaseDatabase();
+
+    // Other clients aren't held by that write
+    EXPECT_NE(api->acquireDatabase(Api::ReadOnly, "bob").connectionName(), primary);
+    api->releaseDatabase();
+}
+
+TEST_F(MetadataTest, KeepsBoundReplicasAcrossReconfiguration)
+{
+    QJsonObject replicas;
+    replicas.insert("urls", QJsonArray({ "sqlite:memory/replica_1" }));
+
+    QJsonObject configuration = api->configuration();
+    configuration.insert("replicas", replicas);
+    api->configure(configuration);
+
+    const QString primary = api->database().connectionName();
+    const QString replica = api->acquireDatabase(Api::ReadOnly).connectionName();
+    ASSERT_NE(replica, primary);
+
+    // The replica is dropped while this thread still uses it
+    configuration.remove("replicas");
+    api->configure(configuration);
+    EXPECT_TRUE(api->replicaUrls().isEmpty());
+    EXPECT_EQ(api->database().connectionName(), replica);
+    EXPECT_TRUE(QSqlDatabase::contains(replica));
+
+    api->releaseDatabase();
+    EXPECT_FALSE(QSqlDatabase::contains(replica));
+    EXPECT_EQ(api->acquireDatabase(Api::ReadOnly).connectionName(), primary);
+    api->releaseDatabase();
+}
+
+TEST_F(MetadataTest, ClassifiesSlowRequests)
+{
+    QJsonObject execution;
+    execution.insert("slow_threshold", 100);
+    execution.insert("timeout", 2000);
+
+    QJsonObject configuration = api->configuration();
+    configuration.insert("execution", execution);
+    api->configure(configuration);
+    EXPECT_EQ(api->slowQueryThreshold(), 100);
+    EXPECT_EQ(api->queryTimeout(), 2000);
+
+    LatencyStats *stats = api->latencyStats();
+    stats->record("GET /products", 20);
+    EXPECT_FALSE(stats->isSlow("GET /products", api->slowQueryThreshold()));
+
+    // A single spike doesn't make an endpoint slow, a steady trend does
+    stats->record("GET /products", 400);
+    EXPECT_FALSE(stats->isSlow("GET /products", api->slowQueryThreshold()));
+    for (int i(0); i < 10; ++i)
+        stats->record("GET /products", 400);
+    EXPECT_TRUE(stats->isSlow("GET /products", api->slowQueryThreshold()));
+    EXPECT_FALSE(stats->isSlow("GET /unknown", api->slowQueryThreshold()));
+
+    const LatencyStats::Entry entry = stats->entry("GET /products");
+    EXPECT_EQ(entry.count, 12);
+    EXPECT_EQ(entry.maximum, 400);
+    EXPECT_EQ(entry.last, 400);
+}
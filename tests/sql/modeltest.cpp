@@ -1,5 +1,10 @@
 #include "modeltest.h"
 
+#include <meta/resourceinfo.h>
+#include <utils/jsonutils.h>
+
+#include <QtSql/qsqlrecord.h>
+
 TEST_F(ModelTest, SuccessfulRead)
 {
     ASSERT_TRUE(model.get(1));
@@ -27,3 +32,92 @@ TEST_F(ModelTest, SuccessfulRead)
     // Marked as hidden
     EXPECT_FALSE(product.contains("category_id"));
 }
+
+TEST_F(ModelTest, SelectsOnlyRequestedFields)
+{
+    QueryOptions options;
+    options.fields = { "id", "name", "unknown" };
+    options.limit = 2;
+
+    bool success = false;
+    const QList<Model> models = Model::getMulti("products", options, api, &success);
+    ASSERT_TRUE(success);
+    ASSERT_EQ(models.count(), 2);
+
+    ASSERT_EQ(log.count(), 1);
+    ASSERT_EQ(log.at(0).toStdString(), R"(SELECT "id", "name" FROM "Products" LIMIT 2)");
+
+    const QJsonObject product = models.first().jsonObject();
+    EXPECT_EQ(product.value("name").toString().toStdString(), "Apple");
+    EXPECT_FALSE(product.contains("description"));
+    EXPECT_FALSE(product.contains("price"));
+}
+
+TEST_F(ModelTest, CombinesFiltersAndSorting)
+{
+    QueryOptions options;
+    options.filters.andWhere("price", ">=", 0.5);
+    options.filters.andWhere("price", "<", 100);
+    options.sortField = "price";
+    options.sortOrder = Qt::AscendingOrder;
+
+    bool success = false;
+    const QList<Model> models = Model::getMulti("products", options, api, &success);
+    ASSERT_TRUE(success);
+
+    ASSERT_EQ(log.count(), 1);
+    ASSERT_EQ(log.at(0).toStdString(), R"(SELECT * FROM "Products" WHERE "price" >= 0.5 AND "price" < 100 ORDER BY "price" ASC)");
+
+    double lastPrice = 0;
+    for (const Model &model : models) {
+        const double price = model.field("price").toDouble();
+        EXPECT_GE(price, lastPrice);
+        lastPrice = price;
+    }
+}
+
+TEST_F(ModelTest, FillsAccordingToMode)
+{
+    const ResourceInfo resource = model.resourceInfo();
+    ASSERT_TRUE(resource.hiddenFields().contains("category_id"));
+    ASSERT_EQ(resource.creationTimestampField().toStdString(), "created_at");
+    ASSERT_EQ(resource.updateTimestampField().toStdString(), "updated_at");
+
+    QJsonObject object;
+    object.insert("id", 1);
+    object.insert("name", "Product 1");
+    object.insert("category_id", 2);
+    object.insert("created_at", "2024-01-01T00:00:00");
+    object.insert("updated_at", "2024-01-02T00:00:00");
+    object.insert("unknown", true);
+
+    // Fillable fields only
+    Model normal(resource, api);
+    normal.fill(object, Model::NormalFill);
+    EXPECT_EQ(normal.field("name").toString().toStdString(), "Product 1");
+    EXPECT_FALSE(normal.field("id").isValid());
+    EXPECT_FALSE(normal.data().contains("category_id"));
+    EXPECT_FALSE(normal.data().contains("created_at"));
+    EXPECT_FALSE(normal.data().contains("unknown"));
+
+    // Hidden fields and timestamps too, never the primary key
+    Model extended(resource, api);
+    extended.fill(object, Model::ExtendedFill);
+    EXPECT_EQ(extended.field("name").toString().toStdString(), "Product 1");
+    EXPECT_EQ(extended.field("category_id").toInt(), 2);
+    EXPECT_EQ(extended.field("created_at").toString().toStdString(), "2024-01-01T00:00:00");
+    EXPECT_EQ(extended.field("updated_at").toString().toStdString(), "2024-01-02T00:00:00");
+    EXPECT_FALSE(extended.field("id").isValid());
+    EXPECT_FALSE(extended.data().contains("unknown"));
+
+    // Everything the table has
+    Model full(resource, api);
+    full.fill(object);
+    EXPECT_EQ(full.field("id").toInt(), 1);
+    EXPECT_EQ(full.field("category_id").toInt(), 2);
+    EXPECT_FALSE(full.data().contains("unknown"));
+
+    const QSqlRecord record = JsonUtils::recordFromObject(object, resource);
+    EXPECT_EQ(record.value("category_id").toInt(), 2);
+    EXPECT_FALSE(record.contains("unknown"));
+}
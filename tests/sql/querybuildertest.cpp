@@ -0,0 +1,54 @@
+#include "querybuildertest.h"
+
+#include <utils/querybuilder.h>
+#include <utils/queryrunner.h>
+
+TEST_F(QueryBuilderTest, GeneratesMultiRowInsert)
+{
+    const QStringList fields = { "name", "price" };
+
+    QList<QVariantHash> rows;
+    rows.append({ { "name", "Orange" }, { "price", 0.7 } });
+    rows.append({ { "name", "Pear" },   { "price", 0.9 } });
+
+    const QString statement = QueryBuilder::insertStatement(products, fields, rows, QueryBuilder::ConflictFail, {}, api);
+    EXPECT_EQ(statement.toStdString(), R"(INSERT INTO "Products" ("name", "price") VALUES ('Orange', 0.7), ('Pear', 0.9))");
+
+    bool success = false;
+    const QSqlQuery query = QueryRunner::exec(statement, api, &success);
+    ASSERT_TRUE(success);
+    EXPECT_EQ(query.numRowsAffected(), 2);
+}
+
+TEST_F(QueryBuilderTest, GeneratesUpsert)
+{
+    const QStringList fields = { "id", "name", "price" };
+
+    QList<QVariantHash> rows;
+    rows.append({ { "id", 1 }, { "name", "Green apple" }, { "price", 0.6 } });
+
+    const QString statement = QueryBuilder::insertStatement(products, fields, rows, QueryBuilder::ConflictUpdate, { "id" }, api);
+    EXPECT_EQ(statement.toStdString(), R"(INSERT INTO "Products" ("id", "name", "price") VALUES (1, 'Green apple', 0.6) ON CONFLICT ("id") DO UPDATE SET "name" = excluded."name", "price" = excluded."price")");
+
+    bool success = false;
+    QueryRunner::exec(statement, api, &success);
+    ASSERT_TRUE(success);
+
+    QSqlQuery query = QueryRunner::exec(R"(SELECT name FROM Products WHERE id = 1)", api);
+    ASSERT_TRUE(query.next());
+    EXPECT_EQ(query.value(0).toString().toStdString(), "Green apple");
+
+    // Updates always get a conflict target
+    EXPECT_EQ(QueryBuilder::insertStatement(products, fields, rows, QueryBuilder::ConflictUpdate, {}, api), statement);
+}
+
+TEST_F(QueryBuilderTest, GeneratesDeleteWithIdentifierList)
+{
+    QueryOptions options;
+    options.filters.andWhereIn("id", { 2, 3 });
+    EXPECT_EQ(QueryBuilder::deleteStatement(products, options, api).toStdString(), R"(DELETE FROM "Products" WHERE "id" IN (2, 3))");
+
+    QueryOptions empty;
+    empty.filters.andWhereIn("id", {});
+    EXPECT_EQ(QueryBuilder::deleteStatement(products, empty, api).toStdString(), R"(DELETE FROM "Products" WHERE 1 = 0)");
+}
@@ -0,0 +1,18 @@
+#ifndef QUERYBUILDERTEST_H
+#define QUERYBUILDERTEST_H
+
+#include "common/sqltest.h"
+
+#include <meta/resourceinfo.h>
+
+using namespace RestLink::Sql;
+
+class QueryBuilderTest : public SqlTest
+{
+protected:
+    QueryBuilderTest() : SqlTest(1) {}
+
+    ResourceInfo products = api->resourceInfo("products");
+};
+
+#endif // QUERYBUILDERTEST_H
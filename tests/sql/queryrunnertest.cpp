@@ -1,8 +1,11 @@
 #include "queryrunnertest.h"
 
 #include <utils/queryrunner.h>
+#include <utils/resultcache.h>
+#include <utils/scriptrunner.h>
 
 #include <QtCore/qjsonarray.h>
+#include <QtCore/qjsondocument.h>
 
 using namespace RestLink;
 using namespace RestLink::Sql;
@@ -59,3 +62,130 @@ TEST_F(QueryRunnerTest, ReturnsDataArrayWhenArrayIsTrue)
     const QString barcode = data.value("barcode").toString();
     EXPECT_EQ(barcode.toStdString(), "1234567890123");
 }
+
+TEST_F(QueryRunnerTest, WritesSameJsonAsObjectSerialization)
+{
+    Query query;
+    query.statement = R"(SELECT * FROM Products ORDER BY id LIMIT 5)";
+    query.array = true;
+
+    const QJsonObject expected = QueryRunner::exec(query, api);
+
+    QByteArray output;
+    ASSERT_TRUE(QueryRunner::exec(query, api, &output));
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(output, &error);
+    ASSERT_EQ(error.error, QJsonParseError::NoError);
+    EXPECT_EQ(doc.object(), expected);
+}
+
+TEST_F(QueryRunnerTest, StreamsRowsInChunks)
+{
+    Query query;
+    query.statement = R"(SELECT * FROM Products ORDER BY id)";
+    query.array = true;
+
+    QByteArray expected;
+    ASSERT_TRUE(QueryRunner::exec(query, api, &expected));
+
+    QByteArray streamed;
+    QByteArray output;
+    ASSERT_TRUE(QueryRunner::exec(query, api, &output, [&streamed](const QByteArray &chunk) {
+        streamed.append(chunk);
+    }));
+    streamed.append(output);
+    EXPECT_EQ(streamed.toStdString(), expected.toStdString());
+
+    // NDJSON: one object per line, matching array items
+    QByteArray lines;
+    ASSERT_TRUE(QueryRunner::exec(query, api, &lines, JsonRecordWriter::Flush(), true));
+
+    const QJsonArray rows = QJsonDocument::fromJson(expected).object().value("data").toArray();
+    const QList<QByteArray> objects = lines.trimmed().split('\n');
+    ASSERT_EQ(objects.size(), rows.size());
+    for (int i(0); i < rows.size(); ++i)
+        EXPECT_EQ(QJsonDocument::fromJson(objects.at(i)).object(), rows.at(i).toObject());
+}
+
+TEST_F(QueryRunnerTest, InvalidatesCachedResultsOnWrite)
+{
+    EXPECT_EQ(ResultCache::tablesOf("SELECT * FROM \"Products\" p JOIN Categories c ON c.id = p.category_id"), QStringList({ "products", "categories" }));
+    EXPECT_TRUE(ResultCache::isReadStatement("  select 1"));
+    EXPECT_FALSE(ResultCache::isReadStatement("UPDATE Products SET price = 1"));
+
+    ResultCachePolicy policy;
+    policy.ttl = 60;
+    policy.maxSize = 1024;
+
+    ResultCache *cache = api->resultCache();
+    const QByteArray key = ResultCache::keyOf("SELECT * FROM Products", { 1 });
+    cache->insert("products", key, "[]", { "Products" }, policy, cache->generation());
+
+    QByteArray data;
+    ASSERT_TRUE(cache->find("products", key, &data));
+    EXPECT_EQ(data, "[]");
+
+    bool success = false;
+    QueryRunner::exec("UPDATE Products SET price = price", api, &success);
+    ASSERT_TRUE(success);
+    EXPECT_FALSE(cache->find("products", key, &data));
+}
+
+TEST_F(QueryRunnerTest, RunsScriptsInTransaction)
+{
+    QVariantList values;
+    EXPECT_EQ(ScriptRunner::shapeOf("INSERT INTO Products (name, price) VALUES ('It''s', 1.5);", &values).toStdString(),
+              "INSERT INTO Products (name, price) VALUES (?, ?);");
+    EXPECT_EQ(values, QVariantList({ "It's", 1.5 }));
+    EXPECT_TRUE(ScriptRunner::shapeOf("SELECT * FROM Products WHERE id = 1", &values).isEmpty());
+
+    values.clear();
+    EXPECT_EQ(ScriptRunner::shapeOf("UPDATE Orders SET due = DATE '2024-01-01' + INTERVAL '1 day' WHERE note = 'a'", &values).toStdString(),
+              "UPDATE Orders SET due = DATE '2024-01-01' + INTERVAL '1 day' WHERE note = ?");
+    EXPECT_EQ(values, QVariantList({ "a" }));
+
+    values.clear();
+    EXPECT_TRUE(ScriptRunner::shapeOf("INSERT INTO Archive SELECT name, price FROM Products WHERE price > 1 ORDER BY 2, 1", &values).isEmpty());
+    EXPECT_TRUE(ScriptRunner::shapeOf("INSERT INTO Totals SELECT name, SUM(price) FROM Products GROUP BY 1", &values).isEmpty());
+
+    values.clear();
+    EXPECT_FALSE(ScriptRunner::shapeOf("INSERT INTO Products (name) VALUES ('C:\\dir')", &values).isEmpty());
+    EXPECT_TRUE(ScriptRunner::shapeOf("INSERT INTO Products (name) VALUES ('C:\\dir')", &values, true).isEmpty());
+
+    auto count = [this] {
+        QSqlQuery query = QueryRunner::exec("SELECT COUNT(*) FROM Products", api);
+        return (query.next() ? query.value(0).toInt() : -1);
+    };
+
+    const int initialCount = count();
+    const QStringList statements = {
+        "INSERT INTO Products (name, price) VALUES ('Kiwi', 0.5);",
+        "INSERT INTO Products (name, price) VALUES ('Lemon', -1);",
+        "INSERT INTO Products (name, price) VALUES ('Mango', 1.2);"
+    };
+
+    // The failing statement undoes the whole script
+    QByteArray output;
+    ScriptRunner runner(api);
+    runner.setTransactional(true);
+    runner.setErrorMode(ScriptRunner::StopOnError);
+    EXPECT_FALSE(runner.run(statements, &output));
+    EXPECT_FALSE(runner.isCommitted());
+    EXPECT_EQ(count(), initialCount);
+
+    const QJsonArray results = QJsonDocument::fromJson(output).array();
+    ASSERT_EQ(results.size(), 2);
+    EXPECT_TRUE(results.at(0).toObject().contains("duration_ms"));
+    EXPECT_TRUE(results.at(1).toObject().contains("error"));
+
+    // Only the failing statement is undone
+    output.clear();
+    runner.setErrorMode(ScriptRunner::ContinueOnError);
+    EXPECT_FALSE(runner.run(statements, &output));
+    EXPECT_TRUE(runner.isCommitted());
+    EXPECT_EQ(runner.successCount(), 2);
+    EXPECT_EQ(runner.failureCount(), 1);
+    EXPECT_EQ(count(), initialCount + 2);
+    EXPECT_EQ(QJsonDocument::fromJson(output).array().size(), 3);
+}
@@ -0,0 +1,142 @@
+#include "requesttest.h"
+
+#include <RestLink/body.h>
+#include <RestLink/header.h>
+#include <RestLink/response.h>
+#include <RestLink/serverresponse.h>
+#include <RestLink/pluginmanager.h>
+
+const void *RequestData::of(const Request &request)
+{
+    // d_ptr is protected, reaching it through a member pointer works on any request
+    return (request.*(&RequestData::d_ptr)).constData();
+}
+
+QStringList TestRequestHandler::supportedSchemes() const
+{
+    return { "requesttest" };
+}
+
+AbstractRequestHandler::HandlerType TestRequestHandler::handlerType() const
+{
+    return ServerHandler;
+}
+
+Response *TestRequestHandler::sendRequest(Method method, const Request &request, const Body &body)
+{
+    Q_UNUSED(body);
+    lastData = RequestData::of(request);
+    lastUrl = request.url().toString();
+    lastHeader = request.header("X-Api").value().toString();
+
+    ServerResponse *response = new ServerResponse(nullptr);
+    initResponse(response, request, method);
+    response->setMethod(method);
+    response->setHttpStatusCode(200);
+    response->complete();
+    return response;
+}
+
+AbstractRequestInterceptor::Stages TestRequestInterceptor::stages() const
+{
+    return ShortCircuitStage | PostResponseStage;
+}
+
+Response *TestRequestInterceptor::respond(AbstractRequestHandler::Method method, const Request &request, const Body &body)
+{
+    Q_UNUSED(body);
+    if (request.endpoint() != "/cached")
+        return nullptr;
+
+    ServerResponse *response = new ServerResponse(nullptr);
+    response->setMethod(method);
+    response->setHttpStatusCode(203);
+    response->complete();
+    return response;
+}
+
+void TestRequestInterceptor::finished(AbstractRequestHandler::Method method, Response *response)
+{
+    Q_UNUSED(method);
+    Q_UNUSED(response);
+    ++finishedCount;
+}
+
+void RequestTest::SetUp()
+{
+    PluginManager::registerHandler(&handler);
+
+    api = new Api();
+    api->setUrl(QUrl("requesttest://api"));
+    api->setHeader("X-Api", "test");
+    api->addQueryParameter("key", "value");
+}
+
+void RequestTest::TearDown()
+{
+    delete api;
+
+    PluginManager::unregisterHandler(&handler);
+}
+
+TEST_F(RequestTest, ReachesHandlerWithoutDetaching)
+{
+    // A request given up by the caller is merged in place, its data goes all the way down
+    Request request("/items");
+    request.setHeader("X-Request", "test");
+    const void *data = RequestData::of(request);
+
+    Response *response = api->get(std::move(request));
+    ASSERT_NE(response, nullptr);
+    EXPECT_EQ(handler.lastData, data);
+    EXPECT_TRUE(handler.lastUrl.contains("key=value"));
+    EXPECT_EQ(handler.lastHeader.toStdString(), "test");
+    delete response;
+
+    // Temporaries take the same path
+    response = api->get(Request("/items"));
+    ASSERT_NE(response, nullptr);
+    EXPECT_TRUE(handler.lastUrl.contains("key=value"));
+    delete response;
+
+    // A request kept by the caller detaches once, and is left untouched
+    Request kept("/items");
+    data = RequestData::of(kept);
+
+    response = api->get(kept);
+    ASSERT_NE(response, nullptr);
+    EXPECT_NE(handler.lastData, data);
+    EXPECT_EQ(RequestData::of(kept), data);
+    EXPECT_FALSE(kept.hasQueryParameter("key"));
+    delete response;
+}
+
+TEST_F(RequestTest, ShortCircuitsInterceptedRequests)
+{
+    TestRequestInterceptor interceptor;
+    handler.addRequestInterceptor(&interceptor);
+
+    // The interceptor's response is the one returned, the handler isn't reached
+    Response *response = api->get(Request("/cached"));
+    ASSERT_NE(response, nullptr);
+    EXPECT_EQ(response->httpStatusCode(), 203);
+    EXPECT_TRUE(handler.lastUrl.isEmpty());
+    EXPECT_EQ(interceptor.finishedCount, 1);
+    delete response;
+
+    // Other requests go through, each one is reported once
+    response = api->get(Request("/items"));
+    ASSERT_NE(response, nullptr);
+    EXPECT_EQ(response->httpStatusCode(), 200);
+    EXPECT_FALSE(handler.lastUrl.isEmpty());
+    EXPECT_EQ(interceptor.finishedCount, 2);
+    delete response;
+
+    // Resuming after an interceptor that isn't in the chain would skip the others
+    TestRequestInterceptor stranger;
+    Request request("/items");
+    request.setBaseUrl(QUrl("requesttest://api"));
+    EXPECT_EQ(handler.proceed(AbstractRequestHandler::GetMethod, request, Body(), &stranger), nullptr);
+
+    handler.removeRequestInterceptor(&interceptor);
+}
@@ -0,0 +1,56 @@
+#ifndef REQUESTTEST_H
+#define REQUESTTEST_H
+
+#include <gtest/gtest.h>
+
+#include <RestLink/api.h>
+#include <RestLink/request.h>
+#include <RestLink/abstractrequesthandler.h>
+#include <RestLink/abstractrequestinterceptor.h>
+
+using namespace RestLink;
+
+// Gives access to the data a request points to, a detach changes it
+class RequestData : public Request
+{
+public:
+    static const void *of(const Request &request);
+};
+
+// Records the data of the requests reaching it
+class TestRequestHandler : public AbstractRequestHandler
+{
+public:
+    const void *lastData = nullptr;
+    QString lastUrl;
+    QString lastHeader;
+
+    QStringList supportedSchemes() const override;
+    HandlerType handlerType() const override;
+
+protected:
+    Response *sendRequest(Method method, const Request &request, const Body &body) override;
+};
+
+// Answers requests to /cached itself, counts the responses it is told about
+class TestRequestInterceptor : public AbstractRequestInterceptor
+{
+public:
+    int finishedCount = 0;
+
+    Stages stages() const override;
+    Response *respond(AbstractRequestHandler::Method method, const Request &request, const Body &body) override;
+    void finished(AbstractRequestHandler::Method method, Response *response) override;
+};
+
+class RequestTest : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    Api *api = nullptr;
+    TestRequestHandler handler;
+};
+
+#endif // REQUESTTEST_H
@@ -0,0 +1,103 @@
+#include "routertest.h"
+
+#include <connectionpool.h>
+#include <utils/latencystats.h>
+#include <utils/queryrunner.h>
+
+#include <RestLink/request.h>
+#include <RestLink/serverrequest.h>
+#include <RestLink/body.h>
+
+#include <QtCore/qjsonarray.h>
+#include <QtCore/qjsonobject.h>
+
+#include <QtTest/qtest.h>
+
+using namespace RestLink;
+
+void RouterTest::SetUp()
+{
+    ASSERT_TRUE(dir.isValid());
+
+    // Executor threads need connections of their own, so the database has to be a file
+    api = Api::api(QUrl("sqlite://" + dir.filePath("router.sqlite")));
+
+    bool success = false;
+    QueryRunner::exec("CREATE TABLE Items (id INTEGER PRIMARY KEY, name TEXT)", api, &success);
+    ASSERT_TRUE(success);
+    QueryRunner::exec("INSERT INTO Items (name) VALUES ('first'), ('second')", api, &success);
+    ASSERT_TRUE(success);
+
+    QJsonObject configuration;
+    configuration.insert("pool", QJsonObject({ { "max_size", 4 } }));
+    configuration.insert("execution", QJsonObject({ { "slow_threshold", 100 }, { "timeout", 100 } }));
+    configuration.insert("endpoints", QJsonObject({
+        { "/items", QJsonObject({ { "get_query", QJsonObject({
+            { "array", true },
+            { "statement", "SELECT name FROM Items ORDER BY id" }
+        }) } }) },
+        { "/counter", QJsonObject({ { "get_query", QJsonObject({
+            { "array", false },
+            { "statement", "WITH RECURSIVE c(x) AS (SELECT 1 UNION ALL SELECT x + 1 FROM c WHERE x < 20000000) SELECT COUNT(*) AS count FROM c" }
+        }) } }) }
+    }));
+    api->configure(configuration);
+    ASSERT_GE(api->connectionPool()->maximumSize(), 2);
+
+    router = new TestRouter();
+    ASSERT_TRUE(router->init());
+}
+
+void RouterTest::TearDown()
+{
+    // Requests still running on the executor use the API
+    delete router;
+    delete api;
+}
+
+ServerResponse *RouterTest::get(const QString &endpoint)
+{
+    // Endpoints taking long on average are the ones sent to the executor
+    for (int i(0); i < 20; ++i)
+        api->latencyStats()->record("GET " + endpoint, 1000);
+
+    Request request(endpoint);
+    request.setBaseUrl(api->url());
+
+    ServerResponse *response = new ServerResponse(nullptr);
+    AbstractServerWorker *worker = router;
+    worker->processStandardRequest(ServerRequest(AbstractRequestHandler::GetMethod, request, Body()), response);
+
+    // Results come back through the router event loop
+    EXPECT_FALSE(response->isFinished());
+    QTest::qWaitFor([response] { return response->isFinished(); }, 10000);
+    return response;
+}
+
+TEST_F(RouterTest, AnswersSlowRequestsFromTheExecutor)
+{
+    ServerResponse *response = get("/items");
+    ASSERT_TRUE(response->isFinished());
+    EXPECT_EQ(response->httpStatusCode(), 200);
+
+    QJsonParseError error;
+    const QJsonArray data = response->readJson(&error).toObject().value("data").toArray();
+    ASSERT_EQ(error.error, QJsonParseError::NoError);
+    ASSERT_EQ(data.size(), 2);
+    EXPECT_EQ(data.at(1).toObject().value("name").toString().toStdString(), "second");
+    delete response;
+}
+
+TEST_F(RouterTest, AnswersTimedOutRequests)
+{
+    // SQLite can't stop the statement, the client still gets its answer on time
+    ServerResponse *response = get("/counter");
+    ASSERT_TRUE(response->isFinished());
+    EXPECT_EQ(response->httpStatusCode(), 504);
+
+    QJsonParseError error;
+    const QJsonObject body = response->readJson(&error).toObject();
+    ASSERT_EQ(error.error, QJsonParseError::NoError);
+    EXPECT_EQ(body.value("message").toString().toStdString(), "query timed out");
+    delete response;
+}
@@ -0,0 +1,36 @@
+#ifndef ROUTERTEST_H
+#define ROUTERTEST_H
+
+#include <gtest/gtest.h>
+
+#include <api.h>
+#include <routing/router.h>
+
+#include <RestLink/serverresponse.h>
+
+#include <QtCore/qtemporarydir.h>
+
+using namespace RestLink::Sql;
+
+// Runs in the test thread, without the worker loop deleting every API on exit
+class TestRouter : public Router
+{
+public:
+    using Router::init;
+};
+
+class RouterTest : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    // Sends a GET through the router, as a slow request, and waits for the client's answer
+    RestLink::ServerResponse *get(const QString &endpoint);
+
+    QTemporaryDir dir;
+    Api *api = nullptr;
+    TestRouter *router = nullptr;
+};
+
+#endif // ROUTERTEST_H
@@ -0,0 +1,149 @@
+#include "tokenprovidertest.h"
+
+#include <RestLink/request.h>
+#include <RestLink/body.h>
+#include <RestLink/header.h>
+#include <RestLink/response.h>
+#include <RestLink/serverresponse.h>
+#include <RestLink/pluginmanager.h>
+
+#include <QtCore/qtimer.h>
+
+#include <QtTest/qtest.h>
+
+void TestTokenProvider::fetchToken()
+{
+    const QString token = QStringLiteral("token-%1").arg(++fetches);
+    QTimer::singleShot(20, this, [this, token] {
+        setToken(token, QDateTime::currentDateTimeUtc().addSecs(3600));
+    });
+}
+
+QStringList TestTokenHandler::supportedSchemes() const
+{
+    return { "tokentest" };
+}
+
+AbstractRequestHandler::HandlerType TestTokenHandler::handlerType() const
+{
+    return ServerHandler;
+}
+
+Response *TestTokenHandler::sendRequest(Method method, const Request &request, const Body &body)
+{
+    Q_UNUSED(body);
+    ++requests;
+
+    ServerResponse *response = new ServerResponse(nullptr);
+    initResponse(response, request, method);
+    response->setMethod(method);
+
+    const bool accepted = (request.header("Authorization").value().toString() == "Bearer " + acceptedToken);
+    response->setHttpStatusCode(accepted ? 200 : 401);
+
+    QTimer::singleShot(0, response, [response, accepted] { response->writeBody(accepted ? "data" : "denied"); });
+    QTimer::singleShot(10, response, &ServerResponse::complete);
+    return response;
+}
+
+void TokenProviderTest::SetUp()
+{
+    PluginManager::registerHandler(&handler);
+
+    api = new Api();
+    api->setUrl(QUrl("tokentest://api"));
+
+    provider = new TestTokenProvider();
+    api->setTokenProvider(provider);
+}
+
+void TokenProviderTest::TearDown()
+{
+    delete api;
+    delete provider;
+
+    PluginManager::unregisterHandler(&handler);
+}
+
+QList<Response *> TokenProviderTest::sendRequests(int count)
+{
+    QList<Response *> responses;
+    for (int i(0); i < count; ++i)
+        responses.append(api->get(Request("/items")));
+    return responses;
+}
+
+bool TokenProviderTest::waitForFinished(const QList<Response *> &responses)
+{
+    return QTest::qWaitFor([&responses] {
+        return std::all_of(responses.cbegin(), responses.cend(), [](Response *response) {
+            return response->isFinished();
+        });
+    }, 5000);
+}
+
+TEST_F(TokenProviderTest, RefreshesOncePerExpiryWhateverTheConcurrency)
+{
+    // Requests sent before any token wait for the same refresh
+    handler.acceptedToken = "token-1";
+    QList<Response *> responses = sendRequests(10);
+    ASSERT_TRUE(waitForFinished(responses));
+
+    EXPECT_EQ(provider->fetches, 1);
+    EXPECT_EQ(handler.requests, 10);
+    for (Response *response : std::as_const(responses))
+        EXPECT_EQ(response->httpStatusCode(), 200);
+    qDeleteAll(responses);
+
+    // The server stops accepting the token, every request in flight gets a 401
+    handler.acceptedToken = "token-2";
+    handler.requests = 0;
+    responses = sendRequests(10);
+    ASSERT_TRUE(waitForFinished(responses));
+
+    EXPECT_EQ(provider->fetches, 2);
+    EXPECT_EQ(handler.requests, 20);
+    for (Response *response : std::as_const(responses))
+        EXPECT_EQ(response->httpStatusCode(), 200);
+    qDeleteAll(responses);
+}
+
+TEST_F(TokenProviderTest, ForwardsDataBeforeFinishing)
+{
+    handler.acceptedToken = "token-1";
+    Response *response = sendRequests(1).constFirst();
+
+    bool readBeforeFinished = false;
+    QObject::connect(response, &QIODevice::readyRead, response, [response, &readBeforeFinished] {
+        readBeforeFinished |= !response->isFinished();
+    });
+
+    ASSERT_TRUE(waitForFinished({ response }));
+    EXPECT_TRUE(readBeforeFinished);
+    EXPECT_EQ(response->httpStatusCode(), 200);
+    delete response;
+}
+
+TEST_F(TokenProviderTest, HidesRejectedAttempts)
+{
+    // The first token gets a 401 with a body of its own, the replay with the next one succeeds
+    handler.acceptedToken = "token-2";
+    Response *response = sendRequests(1).constFirst();
+
+    QByteArray data;
+    QList<int> statuses;
+    QObject::connect(response, &QIODevice::readyRead, response, [response, &data, &statuses] {
+        statuses.append(response->httpStatusCode());
+        data.append(response->readAll());
+    });
+
+    ASSERT_TRUE(waitForFinished({ response }));
+    data.append(response->readAll());
+
+    EXPECT_EQ(provider->fetches, 2);
+    EXPECT_EQ(handler.requests, 2);
+    EXPECT_EQ(response->httpStatusCode(), 200);
+    EXPECT_FALSE(statuses.contains(401));
+    EXPECT_EQ(data.toStdString(), "data");
+    delete response;
+}
@@ -0,0 +1,50 @@
+#ifndef TOKENPROVIDERTEST_H
+#define TOKENPROVIDERTEST_H
+
+#include <gtest/gtest.h>
+
+#include <RestLink/api.h>
+#include <RestLink/abstracttokenprovider.h>
+#include <RestLink/abstractrequesthandler.h>
+
+using namespace RestLink;
+
+// Hands out numbered tokens, a little later to let requests pile up
+class TestTokenProvider : public AbstractTokenProvider
+{
+public:
+    int fetches = 0;
+
+protected:
+    void fetchToken() override;
+};
+
+// Accepts the current token only, bodies of both answers are streamed before responses finish
+class TestTokenHandler : public AbstractRequestHandler
+{
+public:
+    QString acceptedToken;
+    int requests = 0;
+
+    QStringList supportedSchemes() const override;
+    HandlerType handlerType() const override;
+
+protected:
+    Response *sendRequest(Method method, const Request &request, const Body &body) override;
+};
+
+class TokenProviderTest : public testing::Test
+{
+protected:
+    void SetUp() override;
+    void TearDown() override;
+
+    QList<Response *> sendRequests(int count);
+    bool waitForFinished(const QList<Response *> &responses);
+
+    Api *api = nullptr;
+    TestTokenProvider *provider = nullptr;
+    TestTokenHandler handler;
+};
+
+#endif // TOKENPROVIDERTEST_H